@@ -81,29 +81,14 @@ class Camera
             offset.y = radius * std::sin(pitchRad);
             offset.z = radius * std::cos(pitchRad) * std::sin(yawRad);
 
-            position = glm::vec3(target.x + offset.x,
-                                 target.y + offset.y,
-                                 target.z + offset.z);
+            position = target + offset;
 
-            float len = std::sqrt(offset.x*offset.x + offset.y*offset.y + offset.z*offset.z);
+            float len = glm::length(offset);
             if (len > 0.0f)
-                front = glm::vec3(-offset.x / len, -offset.y / len, -offset.z / len);
-
-            glm::vec3 right;
-            right.x = front.y * worldup.z - front.z * worldup.y;
-            right.y = front.z * worldup.x - front.x * worldup.z;
-            right.z = front.x * worldup.y - front.y * worldup.x;
-            len = std::sqrt(right.x*right.x + right.y*right.y + right.z*right.z);
-            if (len > 0.0f) { right.x /= len; right.y /= len; right.z /= len; }
-            this->right = right;
-
-            glm::vec3 up;
-            up.x = right.y * front.z - right.z * front.y;
-            up.y = right.z * front.x - right.x * front.z;
-            up.z = right.x * front.y - right.y * front.x;
-            len = std::sqrt(up.x*up.x + up.y*up.y + up.z*up.z);
-            if (len > 0.0f) { up.x /= len; up.y /= len; up.z /= len; }
-            this->up = up;
+                front = -offset / len;
+
+            right = glm::normalize(glm::cross(front, worldup));
+            up = glm::normalize(glm::cross(right, front));
         }
 };
 
@@ -2,6 +2,9 @@
 #define ANIMATION_HPP
 
 #include "include.hpp"
+#include "rig.hpp"
+#include "clip.hpp"
+#include "pose.hpp"
 
 enum Animations //ajouter des animations pour avoir 10 int (0-9)
 {
@@ -15,19 +18,174 @@ enum Animations //ajouter des animations pour avoir 10 int (0-9)
     GANGNAM_STYLE, // AIGLES QUI HURLENT FORT MURICAAAAAAAA
     MJ_PENCHING, // Michael Jackson - Billie Jean
     HARDBASS_ROBLOX, // titre
+    ANIMATION_COUNT
 };
 
+// keyframed clip behind state, nullptr for the procedural ones
+const Clip* getStateClip(Animations state);
+
+// how a layer combines with the pose below it on the joints of its mask
+enum LayerMode
+{
+    LAYER_OVERRIDE, // replaces the pose, faded in by the layer weight
+    LAYER_ADDITIVE  // rotates and moves on top of the pose, scaled by the layer weight
+};
+
+constexpr int ANIM_MAX_LAYERS = 4;
+
+// where one playing instance is in its clip's keys: those of the keyframed
+// clip when it is evaluated, those of its packed table when it is baked
+struct PlayCursor
+{
+    ClipCursor clip;
+    PackedCursor packed;
+
+    void reset()
+    {
+        clip.reset();
+        packed.reset();
+    }
+};
+
+// looping clips sampled ahead of time into contiguous pose tables, so playing
+// one is a table lookup plus a lerp whatever the clip's own math costs.
+// Shared by every Animator; clips that do not loop are not baked. The tables
+// can be compressed afterwards, trading memory for several times the
+// sampling cost on clips with many keys.
+class BakedPoses
+{
+    private:
+        struct Table
+        {
+            float period = 0.0f;
+            float rate = 0.0f; // frames per second, adjusted so period is a whole number of frames
+            int frameCount = 0; // frames in one period; frames holds one extra, equal to the first
+            std::vector<Pose> frames; // empty once packed
+            PackedPoses packed;
+        };
+        Table _tables[ANIMATION_COUNT];
+
+    public:
+        // samples every looping clip at about rate frames per second
+        void bake(float rate);
+        // packs every baked table (see PackedPoses) and frees its raw frames
+        void compress(float rotError, float transError);
+        bool isBaked(Animations state) const { return _tables[state].frameCount > 0; }
+        // memory held by the table of state, raw or packed
+        size_t byteSize(Animations state) const;
+        // pose of a baked clip at time t, written for the joints in mask only;
+        // state must be baked. cursor is only used by packed tables
+        void sample(Animations state, float t, PackedCursor& cursor, Pose& pose, JointMask mask = MASK_ALL) const;
+};
+
+// per-instance animation state: clip, time, root transform and the joint
+// pose evaluated from them. Everything shared lives in the Rig.
 class Animator
 {
     private:
         int   _state;
         float _time;
+        // current key of each track of the playing clip
+        PlayCursor _cursor;
+        // outgoing clip, kept playing while a cross-fade runs
+        int   _fromState;
+        float _fromTime;
+        PlayCursor _fromCursor;
+        // outgoing pose instead, held still, when a fade was cut off midway
+        Pose _fromPose;
+        bool _fromFrozen;
+        // base pose the last evaluate() of the running fade blended
+        Pose _fadePose;
+        bool _fadeSampled;
+        float _fadeTime;
+        float _fadeLength; // 0 when no cross-fade is running
+        float _crossFade;  // fade length used by setState(state)
+        // clips played over the base one, applied in slot order; a slot with
+        // an empty mask is free
+        struct Layer
+        {
+            int state = NONE;
+            float time = 0.0f;
+            PlayCursor cursor;
+            JointMask mask = 0;
+            LayerMode mode = LAYER_OVERRIDE;
+            float weight = 0.0f;
+        };
+        Layer _layers[ANIM_MAX_LAYERS];
+        glm::mat4 _root;
+        // last evaluated joint pose and world matrices, kept to skip unchanged joints
+        Pose _pose;
+        glm::mat4 _world[JOINT_COUNT];
+        bool _jointDirty[JOINT_COUNT];
+        bool _poseValid;
+        const Rig* _posedRig;
+        int _jointsUpdated;
+        // pose of the evaluate() before the last one, and the world matrices
+        // interpolate() builds between the two
+        Pose _prevPose;
+        glm::mat4 _drawWorld[JOINT_COUNT];
+        bool _interpolated;
+
+        int updateJoints(const Rig& rig, const Pose& pose);
 
     public:
         Animator();
+        // switches clip, cross-fading from the current one over the default length
         void setState(Animations state);
+        // switches clip with a cross-fade of fadeSeconds; 0 snaps to the new clip
+        void setState(Animations state, float fadeSeconds);
+        void setCrossFade(float seconds) { _crossFade = seconds; }
+        bool isFading() const { return _fadeLength > 0.0f; }
         void update(float deltaTime);
-        void draw(Shader& shader, body& myBody);
+        // plays state over the joints of mask, on top of the base clip and the
+        // layers in lower slots; returns the slot, -1 when all are taken
+        int addLayer(Animations state, JointMask mask, LayerMode mode, float weight = 1.0f);
+        void setLayerWeight(int layer, float weight) { _layers[layer].weight = weight; }
+        void removeLayer(int layer) { _layers[layer] = Layer(); }
+        // places the whole character; joint 0 hangs off this matrix
+        void setRoot(const glm::mat4& root);
+        const glm::mat4& getRoot() const { return _root; }
+        // evaluates the current clip into joint world matrices for rig; clips
+        // found in baked are read from their tables instead of evaluated
+        void evaluate(const Rig& rig, const BakedPoses* baked = nullptr);
+        const glm::mat4* getJointWorld() const { return _world; }
+        // poses the joints alpha of the way from the previous evaluate() to
+        // the last one, for drawing between two fixed simulation steps
+        void interpolate(const Rig& rig, float alpha);
+        // matrices to draw: interpolate()'s until the next evaluate(), else getJointWorld()
+        const glm::mat4* getDrawWorld() const { return _interpolated ? _drawWorld : _world; }
+        // false until the first evaluate() after a reset
+        bool isPosed() const { return _posedRig != nullptr; }
+        // joints whose world matrix the last evaluate() recomputed
+        int getJointsUpdated() const { return _jointsUpdated; }
+};
+
+// draws posed instances of a rig; the per-part scratch lives here, shared by
+// every instance drawn through the same renderer. The scratch is laid out
+// part-major, structure of arrays over the instances: the copies of part p
+// of all instances are contiguous, so each part is posed for the whole
+// crowd in one batch and every draw group is walked crowd-wide.
+class RigRenderer
+{
+    private:
+        int _instances; // instances in the scratch; part p of instance i is at p * _instances + i
+        std::vector<glm::mat4> _poseMats;
+        std::vector<glm::mat4> _models;
+        std::vector<glm::aabb> _bounds;
+        std::vector<unsigned char> _visible;
+        glm::frustum _frustum;
+        bool _cull;
+
+        void drawParts(Shader& shader, const body& myBody, const BodyPartType* types, int n) const;
+
+    public:
+        RigRenderer();
+        // parts outside this view-projection are skipped by draw()
+        void setViewProjection(const glm::mat4& viewProjection);
+        // draws rig in the pose last evaluated or interpolated by animator
+        void draw(Shader& shader, const Rig& rig, const Animator& animator);
+        // draws rig once for each of the count animators, all posed
+        void draw(Shader& shader, const Rig& rig, const Animator* const* animators, int count);
 };
 
 #endif
\ No newline at end of file
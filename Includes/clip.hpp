@@ -0,0 +1,74 @@
+#ifndef CLIP_HPP
+#define CLIP_HPP
+
+// Keyframe clips: each track animates one scalar channel with a list of
+// keys. A clip is plain constant data, sampled through a per-instance
+// ClipCursor that remembers the current key of every track, so playing
+// forward costs O(1) per track instead of a search.
+
+// how a segment is interpolated, set on the key that starts it
+enum KeyInterp
+{
+    INTERP_STEP,    // hold the key's value until the next key
+    INTERP_LINEAR,
+    INTERP_SMOOTH,  // smoothstep (easeInOut) between the two values
+    INTERP_HERMITE  // cubic through both values using their tangents
+};
+
+struct Keyframe
+{
+    float time;    // seconds from the start of the clip
+    float value;
+    KeyInterp interp;
+    float tangent = 0.0f; // slope (units per second), used by INTERP_HERMITE
+};
+
+struct ClipTrack
+{
+    int channel; // which output the track writes, meaning is up to the caller
+    // second output fed the same sample times mirrorScale (left/right pairs),
+    // -1 for none
+    int mirror;
+    float mirrorScale;
+    const Keyframe* keys;
+    int keyCount;
+    // sampled on the clip's unwrapped time and continued past the last key
+    // along the last segment's slope (root motion that keeps going)
+    bool extrapolate;
+};
+
+struct Clip
+{
+    const ClipTrack* tracks;
+    int trackCount;
+    float duration;
+    // past duration the clip repeats [loopStart, duration); a clip that does
+    // not loop holds its last values
+    bool loop;
+    float loopStart;
+};
+
+// smoothstep on [0, 1]: eases in and out with zero slope at both ends
+constexpr float easeInOut(float x)
+{
+    return x * x * (3.0f - 2.0f * x);
+}
+
+constexpr int CLIP_MAX_TRACKS = 16;
+
+struct ClipCursor
+{
+    int key[CLIP_MAX_TRACKS] = {};
+
+    void reset()
+    {
+        for (int& k : key)
+            k = 0;
+    }
+};
+
+// writes every track of clip at time t into out[track.channel] (and its
+// mirror); channels no track touches are left as they are
+void sampleClip(const Clip& clip, float t, ClipCursor& cursor, float* out);
+
+#endif
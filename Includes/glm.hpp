@@ -4,34 +4,75 @@
 #include <cmath>
 #include <cstring>
 
+// SIMD backend for the mat4 product, picked at compile time from the target
+// flags. Define GLM_FORCE_SCALAR to always use the reference loop.
+#if !defined(GLM_FORCE_SCALAR) && defined(__AVX__)
+# define GLM_SIMD_AVX 1
+# define GLM_SIMD_SSE 1
+# include <immintrin.h>
+#elif !defined(GLM_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+// the batch kernels convert through int32, which needs SSE2
+# define GLM_SIMD_SSE 1
+# include <emmintrin.h>
+#elif !defined(GLM_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+# define GLM_SIMD_NEON 1
+# include <arm_neon.h>
+#endif
+
 #define PI 3.14159265359f
 
 namespace glm {
 
 struct vec3 {
     float x, y, z;
-    vec3() : x(0), y(0), z(0) {}
-    vec3(float X, float Y, float Z) : x(X), y(Y), z(Z) {}
-    float& operator[](int i) { return i==0? x : (i==1? y : z); }
-    const float& operator[](int i) const { return i==0? x : (i==1? y : z); }
-    const vec3 operator-(const vec3 other) const { return vec3(x - other.x, y - other.y, z - other.z); }
-    const vec3 operator+(const vec3 other) const { return vec3(x + other.x, y + other.y, z + other.z); }
+    constexpr vec3() : x(0), y(0), z(0) {}
+    constexpr vec3(float X, float Y, float Z) : x(X), y(Y), z(Z) {}
+    constexpr float& operator[](int i) { return i==0? x : (i==1? y : z); }
+    constexpr const float& operator[](int i) const { return i==0? x : (i==1? y : z); }
+    constexpr const vec3 operator-(const vec3 other) const { return vec3(x - other.x, y - other.y, z - other.z); }
+    constexpr const vec3 operator+(const vec3 other) const { return vec3(x + other.x, y + other.y, z + other.z); }
+    constexpr const vec3 operator-() const { return vec3(-x, -y, -z); }
+    constexpr vec3& operator+=(const vec3& other) { x += other.x; y += other.y; z += other.z; return *this; }
+    constexpr vec3& operator-=(const vec3& other) { x -= other.x; y -= other.y; z -= other.z; return *this; }
+    constexpr vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+    constexpr vec3& operator/=(float s) { x /= s; y /= s; z /= s; return *this; }
 };
 
+// the rest of the vec3 algebra; all constexpr inline so chains like
+// a + b * s - c fold into straight-line code with no temporaries left
+constexpr vec3 operator*(const vec3& v, float s) { return vec3(v.x * s, v.y * s, v.z * s); }
+constexpr vec3 operator*(float s, const vec3& v) { return vec3(v.x * s, v.y * s, v.z * s); }
+constexpr vec3 operator*(const vec3& a, const vec3& b) { return vec3(a.x * b.x, a.y * b.y, a.z * b.z); }
+constexpr vec3 operator/(const vec3& v, float s) { return vec3(v.x / s, v.y / s, v.z / s); }
+constexpr bool operator==(const vec3& a, const vec3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+constexpr bool operator!=(const vec3& a, const vec3& b) { return !(a == b); }
+
+constexpr vec3 min(const vec3& a, const vec3& b) {
+    return vec3(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z);
+}
+
+constexpr vec3 max(const vec3& a, const vec3& b) {
+    return vec3(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z);
+}
+
+constexpr vec3 lerp(const vec3& a, const vec3& b, float t) {
+    return vec3(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+}
+
 struct vec2 {
     float x, y;
-    vec2() : x(0), y(0) {}
-    vec2(float X, float Y) : x(X), y(Y) {}
-    float& operator[](int i) { return i==0? x : y; }
-    const float& operator[](int i) const { return i==0? x : y; }
+    constexpr vec2() : x(0), y(0) {}
+    constexpr vec2(float X, float Y) : x(X), y(Y) {}
+    constexpr float& operator[](int i) { return i==0? x : y; }
+    constexpr const float& operator[](int i) const { return i==0? x : y; }
 };
 
 struct vec4 {
     float x, y, z, w;
-    vec4() : x(0), y(0), z(0), w(0) {}
-    vec4(float X, float Y, float Z, float W) : x(X), y(Y), z(Z), w(W) {}
-    float& operator[](int i) { return i==0? x : (i==1? y : (i==2? z : w)); }
-    const float& operator[](int i) const { return i==0? x : (i==1? y : (i==2? z : w)); }
+    constexpr vec4() : x(0), y(0), z(0), w(0) {}
+    constexpr vec4(float X, float Y, float Z, float W) : x(X), y(Y), z(Z), w(W) {}
+    constexpr float& operator[](int i) { return i==0? x : (i==1? y : (i==2? z : w)); }
+    constexpr const float& operator[](int i) const { return i==0? x : (i==1? y : (i==2? z : w)); }
 };
 
 struct mat4 {
@@ -40,43 +81,234 @@ struct mat4 {
     mat4() {
     }
 
-    explicit mat4(float diagonal) {
-        for (int i = 0; i < 16; ++i) data[i] = 0.0f;
-        data[0] = diagonal;
-        data[5] = diagonal;
-        data[10] = diagonal;
-        data[15] = diagonal;
+    constexpr explicit mat4(float diagonal)
+        : data{diagonal, 0, 0, 0,
+               0, diagonal, 0, 0,
+               0, 0, diagonal, 0,
+               0, 0, 0, diagonal} {
     }
-    float* operator[](int col) { return &data[col * 4]; }
-    const float* operator[](int col) const { return &data[col * 4]; }
+    constexpr float* operator[](int col) { return &data[col * 4]; }
+    constexpr const float* operator[](int col) const { return &data[col * 4]; }
 };
 
 // mat3 and mat2 to satisfy shader helper
 struct mat3 {
     float data[9];
     mat3() {}
-    explicit mat3(float diagonal) {
-        for (int i = 0; i < 9; ++i) data[i] = 0.0f;
-        data[0] = diagonal; data[4] = diagonal; data[8] = diagonal;
+    constexpr explicit mat3(float diagonal)
+        : data{diagonal, 0, 0,
+               0, diagonal, 0,
+               0, 0, diagonal} {
     }
-    float* operator[](int col) { return &data[col*3]; }
-    const float* operator[](int col) const { return &data[col*3]; }
+    constexpr float* operator[](int col) { return &data[col*3]; }
+    constexpr const float* operator[](int col) const { return &data[col*3]; }
 };
 
 struct mat2 {
     float data[4];
     mat2() {}
-    explicit mat2(float diagonal) {
-        for (int i = 0; i < 4; ++i) data[i] = 0.0f;
-        data[0] = diagonal; data[3] = diagonal;
+    constexpr explicit mat2(float diagonal)
+        : data{diagonal, 0,
+               0, diagonal} {
     }
-    float* operator[](int col) { return &data[col*2]; }
-    const float* operator[](int col) const { return &data[col*2]; }
+    constexpr float* operator[](int col) { return &data[col*2]; }
+    constexpr const float* operator[](int col) const { return &data[col*2]; }
 };
 
-// multiply two mat4 (column-major)
-inline mat4 operator*(const mat4& A, const mat4& B) {
-    mat4 R;
+constexpr float dot(const vec3 &a, const vec3 &b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline float length(const vec3 &v) {
+    return std::sqrt(dot(v, v));
+}
+
+inline vec3 normalize(const vec3 &v) {
+    float len = length(v);
+    if (len > 0.0f) {
+        return v / len;
+    }
+    return v;
+}
+
+constexpr vec3 cross(const vec3 &a, const vec3 &b) {
+    return vec3(
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x
+    );
+}
+
+// ---------------------------------------------------------------------------
+// Lane-parallel float used by the batch kernels: 8 lanes with AVX, 4 with
+// SSE/NEON, 1 on the scalar fallback. Masks are all-ones/all-zeros lanes
+// (1.0f/0.0f on the scalar fallback) and only feed simd_select.
+// ---------------------------------------------------------------------------
+#if defined(GLM_SIMD_AVX)
+# define GLM_SIMD_WIDTH 8
+typedef __m256 simdf;
+inline simdf simd_load(const float* p) { return _mm256_load_ps(p); }
+inline void simd_store(float* p, simdf v) { _mm256_store_ps(p, v); }
+inline simdf simd_set1(float f) { return _mm256_set1_ps(f); }
+inline simdf simd_add(simdf a, simdf b) { return _mm256_add_ps(a, b); }
+inline simdf simd_sub(simdf a, simdf b) { return _mm256_sub_ps(a, b); }
+inline simdf simd_mul(simdf a, simdf b) { return _mm256_mul_ps(a, b); }
+inline simdf simd_round(simdf a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline simdf simd_floor(simdf a) { return _mm256_floor_ps(a); }
+inline simdf simd_cmpeq(simdf a, simdf b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+inline simdf simd_cmpge(simdf a, simdf b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+inline simdf simd_select(simdf mask, simdf a, simdf b) { return _mm256_blendv_ps(b, a, mask); }
+#elif defined(GLM_SIMD_SSE)
+# define GLM_SIMD_WIDTH 4
+typedef __m128 simdf;
+inline simdf simd_load(const float* p) { return _mm_load_ps(p); }
+inline void simd_store(float* p, simdf v) { _mm_store_ps(p, v); }
+inline simdf simd_set1(float f) { return _mm_set1_ps(f); }
+inline simdf simd_add(simdf a, simdf b) { return _mm_add_ps(a, b); }
+inline simdf simd_sub(simdf a, simdf b) { return _mm_sub_ps(a, b); }
+inline simdf simd_mul(simdf a, simdf b) { return _mm_mul_ps(a, b); }
+// SSE2 has no round/floor instructions: go through int32 (|a| < 2^31)
+inline simdf simd_round(simdf a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+inline simdf simd_floor(simdf a) {
+    simdf t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+}
+inline simdf simd_cmpeq(simdf a, simdf b) { return _mm_cmpeq_ps(a, b); }
+inline simdf simd_cmpge(simdf a, simdf b) { return _mm_cmpge_ps(a, b); }
+inline simdf simd_select(simdf mask, simdf a, simdf b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#elif defined(GLM_SIMD_NEON)
+# define GLM_SIMD_WIDTH 4
+typedef float32x4_t simdf;
+inline simdf simd_load(const float* p) { return vld1q_f32(p); }
+inline void simd_store(float* p, simdf v) { vst1q_f32(p, v); }
+inline simdf simd_set1(float f) { return vdupq_n_f32(f); }
+inline simdf simd_add(simdf a, simdf b) { return vaddq_f32(a, b); }
+inline simdf simd_sub(simdf a, simdf b) { return vsubq_f32(a, b); }
+inline simdf simd_mul(simdf a, simdf b) { return vmulq_f32(a, b); }
+inline simdf simd_floor(simdf a) {
+    simdf t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+    return vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(t, a), vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+}
+inline simdf simd_round(simdf a) { return simd_floor(vaddq_f32(a, vdupq_n_f32(0.5f))); }
+inline simdf simd_cmpeq(simdf a, simdf b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+inline simdf simd_cmpge(simdf a, simdf b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+inline simdf simd_select(simdf mask, simdf a, simdf b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+#else
+# define GLM_SIMD_WIDTH 1
+typedef float simdf;
+inline simdf simd_load(const float* p) { return *p; }
+inline void simd_store(float* p, simdf v) { *p = v; }
+inline simdf simd_set1(float f) { return f; }
+inline simdf simd_add(simdf a, simdf b) { return a + b; }
+inline simdf simd_sub(simdf a, simdf b) { return a - b; }
+inline simdf simd_mul(simdf a, simdf b) { return a * b; }
+inline simdf simd_round(simdf a) { return std::floor(a + 0.5f); }
+inline simdf simd_floor(simdf a) { return std::floor(a); }
+inline simdf simd_cmpeq(simdf a, simdf b) { return a == b ? 1.0f : 0.0f; }
+inline simdf simd_cmpge(simdf a, simdf b) { return a >= b ? 1.0f : 0.0f; }
+inline simdf simd_select(simdf mask, simdf a, simdf b) { return mask != 0.0f ? a : b; }
+#endif
+
+// ---------------------------------------------------------------------------
+// sincos: one range reduction to [-pi/4, pi/4] (Cody-Waite, pi/2 split in
+// three parts) then a sin and a cos polynomial, quadrant fixed up at the end.
+//
+// Default tier (full float), measured against double-precision libm:
+//   |x| <= 8192   abs error <= 1e-7 for sin and cos (about 1 ulp near 1)
+// GLM_SINCOS_FAST tier (animation grade, two shorter polynomials):
+//   |x| <= 8192   abs error <= 2.7e-5 for sin and cos
+// Past |x| = 8192 the reduction loses bits; animation angles never get there.
+// ---------------------------------------------------------------------------
+#define GLM_TWO_OVER_PI 0.636619772367581f
+#define GLM_PIO2_A 1.5703125f
+#define GLM_PIO2_B 4.837512969970703125e-4f
+#define GLM_PIO2_C 7.54978995489188216e-8f
+
+#if defined(GLM_SINCOS_FAST)
+# define GLM_SIN_POLY(r, r2) ((r) + (r) * (r2) * (-0.166633818f + (r2) * 0.00816544861f))
+# define GLM_COS_POLY(r2) (1.0f + (r2) * (-0.499815974f + (r2) * 0.0405886111f))
+#else
+# define GLM_SIN_POLY(r, r2) ((r) + (r) * (r2) * (-1.6666654611e-1f + (r2) * (8.3321608736e-3f + (r2) * -1.9515295891e-4f)))
+# define GLM_COS_POLY(r2) (1.0f - 0.5f * (r2) + (r2) * (r2) * (4.166664568298827e-2f + (r2) * (-1.388731625493765e-3f + (r2) * 2.443315711809948e-5f)))
+#endif
+
+inline void sincos(float x, float& s, float& c) {
+    float q = std::floor(x * GLM_TWO_OVER_PI + 0.5f);
+    float r = ((x - q * GLM_PIO2_A) - q * GLM_PIO2_B) - q * GLM_PIO2_C;
+    float r2 = r * r;
+    float ps = GLM_SIN_POLY(r, r2);
+    float pc = GLM_COS_POLY(r2);
+    int quadrant = static_cast<int>(q) & 3;
+    switch (quadrant) {
+        case 0: s = ps;  c = pc;  break;
+        case 1: s = pc;  c = -ps; break;
+        case 2: s = -ps; c = -pc; break;
+        default: s = -pc; c = ps; break;
+    }
+}
+
+inline float sin(float x) { float s, c; sincos(x, s, c); return s; }
+inline float cos(float x) { float s, c; sincos(x, s, c); return c; }
+
+// GLM_SIMD_WIDTH angles at once, same polynomials and error bounds as sincos
+inline void sincos_simd(simdf x, simdf& s, simdf& c) {
+    const simdf q = simd_round(simd_mul(x, simd_set1(GLM_TWO_OVER_PI)));
+    simdf r = simd_sub(x, simd_mul(q, simd_set1(GLM_PIO2_A)));
+    r = simd_sub(r, simd_mul(q, simd_set1(GLM_PIO2_B)));
+    r = simd_sub(r, simd_mul(q, simd_set1(GLM_PIO2_C)));
+    const simdf r2 = simd_mul(r, r);
+    const simdf one = simd_set1(1.0f);
+    simdf ps, pc;
+#if defined(GLM_SINCOS_FAST)
+    ps = simd_add(simd_set1(-0.166633818f), simd_mul(r2, simd_set1(0.00816544861f)));
+    ps = simd_add(r, simd_mul(simd_mul(r, r2), ps));
+    pc = simd_add(simd_set1(-0.499815974f), simd_mul(r2, simd_set1(0.0405886111f)));
+    pc = simd_add(one, simd_mul(r2, pc));
+#else
+    ps = simd_add(simd_set1(8.3321608736e-3f), simd_mul(r2, simd_set1(-1.9515295891e-4f)));
+    ps = simd_add(simd_set1(-1.6666654611e-1f), simd_mul(r2, ps));
+    ps = simd_add(r, simd_mul(simd_mul(r, r2), ps));
+    pc = simd_add(simd_set1(-1.388731625493765e-3f), simd_mul(r2, simd_set1(2.443315711809948e-5f)));
+    pc = simd_add(simd_set1(4.166664568298827e-2f), simd_mul(r2, pc));
+    pc = simd_add(simd_sub(one, simd_mul(simd_set1(0.5f), r2)), simd_mul(simd_mul(r2, r2), pc));
+#endif
+    // quadrant = q mod 4 in [0, 3], kept in float lanes
+    const simdf quadrant = simd_sub(q, simd_mul(simd_set1(4.0f), simd_floor(simd_mul(q, simd_set1(0.25f)))));
+    const simdf odd = simd_sub(quadrant, simd_mul(simd_set1(2.0f), simd_floor(simd_mul(quadrant, simd_set1(0.5f)))));
+    const simdf swap = simd_cmpeq(odd, one);
+    const simdf zero = simd_set1(0.0f);
+    simdf sv = simd_select(swap, pc, ps);
+    simdf cv = simd_select(swap, ps, pc);
+    // sin is negative in quadrants 2 and 3, cos in quadrants 1 and 2
+    const simdf negS = simd_cmpge(quadrant, simd_set1(2.0f));
+    const simdf d = simd_sub(quadrant, simd_set1(1.5f));
+    const simdf negC = simd_cmpeq(simd_mul(d, d), simd_set1(0.25f));
+    s = simd_select(negS, simd_sub(zero, sv), sv);
+    c = simd_select(negC, simd_sub(zero, cv), cv);
+}
+
+// s[i], c[i] = sin(x[i]), cos(x[i]) for n angles, GLM_SIMD_WIDTH per step
+inline void sincosBatch(const float* x, float* s, float* c, int n) {
+    alignas(32) float in[GLM_SIMD_WIDTH], outS[GLM_SIMD_WIDTH], outC[GLM_SIMD_WIDTH];
+    for (int i = 0; i < n; i += GLM_SIMD_WIDTH) {
+        int count = n - i < GLM_SIMD_WIDTH ? n - i : GLM_SIMD_WIDTH;
+        for (int j = 0; j < GLM_SIMD_WIDTH; ++j)
+            in[j] = j < count ? x[i + j] : 0.0f;
+        simdf vs, vc;
+        sincos_simd(simd_load(in), vs, vc);
+        simd_store(outS, vs);
+        simd_store(outC, vc);
+        for (int j = 0; j < count; ++j) {
+            s[i + j] = outS[j];
+            c[i + j] = outC[j];
+        }
+    }
+}
+
+// multiply two mat4 (column-major) - reference path, kept for the
+// GLM_FORCE_SCALAR build and to check the SIMD versions against
+constexpr mat4 mul_scalar(const mat4& A, const mat4& B) {
+    mat4 R(0.0f);
     for (int col = 0; col < 4; ++col) {
         for (int row = 0; row < 4; ++row) {
             float sum = 0.0f;
@@ -89,47 +321,689 @@ inline mat4 operator*(const mat4& A, const mat4& B) {
     return R;
 }
 
-// translate: returns T * M (so transform = translate(transform, v) behaves like glm)
-inline mat4 translate(const mat4& M, const vec3& v) {
-    mat4 T(1.0f);
-    T.data[12] = v.x;
-    T.data[13] = v.y;
-    T.data[14] = v.z;
-    return M * T;
+// each result column is a linear combination of the columns of A:
+// R[c] = A[0]*B[c][0] + A[1]*B[c][1] + A[2]*B[c][2] + A[3]*B[c][3]
+inline mat4 mul_simd(const mat4& A, const mat4& B) {
+    mat4 R;
+#if defined(GLM_SIMD_AVX)
+    // two result columns per iteration: each 128-bit half holds one column
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&A.data[0]));
+    const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&A.data[4]));
+    const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&A.data[8]));
+    const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&A.data[12]));
+    for (int col = 0; col < 4; col += 2) {
+        const __m256 b = _mm256_loadu_ps(&B.data[col*4]);
+        __m256 r = _mm256_mul_ps(a0, _mm256_permute_ps(b, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_permute_ps(b, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_permute_ps(b, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_permute_ps(b, 0xFF)));
+        _mm256_storeu_ps(&R.data[col*4], r);
+    }
+#elif defined(GLM_SIMD_SSE)
+    const __m128 a0 = _mm_loadu_ps(&A.data[0]);
+    const __m128 a1 = _mm_loadu_ps(&A.data[4]);
+    const __m128 a2 = _mm_loadu_ps(&A.data[8]);
+    const __m128 a3 = _mm_loadu_ps(&A.data[12]);
+    for (int col = 0; col < 4; ++col) {
+        const float* b = &B.data[col*4];
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+        _mm_storeu_ps(&R.data[col*4], r);
+    }
+#elif defined(GLM_SIMD_NEON)
+    const float32x4_t a0 = vld1q_f32(&A.data[0]);
+    const float32x4_t a1 = vld1q_f32(&A.data[4]);
+    const float32x4_t a2 = vld1q_f32(&A.data[8]);
+    const float32x4_t a3 = vld1q_f32(&A.data[12]);
+    for (int col = 0; col < 4; ++col) {
+        const float* b = &B.data[col*4];
+        float32x4_t r = vmulq_n_f32(a0, b[0]);
+        r = vmlaq_n_f32(r, a1, b[1]);
+        r = vmlaq_n_f32(r, a2, b[2]);
+        r = vmlaq_n_f32(r, a3, b[3]);
+        vst1q_f32(&R.data[col*4], r);
+    }
+#else
+    R = mul_scalar(A, B);
+#endif
+    return R;
 }
 
-// rotate: angle in radians, axis normalized-ish
-inline mat4 rotate(const mat4& M, float angle, const vec3& axis) {
-    float c = std::cos(angle);
-    float s = std::sin(angle);
+inline mat4 operator*(const mat4& A, const mat4& B) {
+    return mul_simd(A, B);
+}
+
+// In-place post-multiplication by affine factors: M = M * X where X is a
+// translation, scale or rotation. Only the columns of M that X actually
+// changes are touched, instead of building X and doing a full product.
+
+// M = M * T(v): only the translation column moves
+constexpr void postTranslate(mat4& M, const vec3& v) {
+    for (int row = 0; row < 4; ++row)
+        M.data[12 + row] += M.data[row] * v.x + M.data[4 + row] * v.y + M.data[8 + row] * v.z;
+}
+
+// M = M * S(v): scales the three basis columns
+constexpr void postScale(mat4& M, const vec3& v) {
+    for (int row = 0; row < 4; ++row) {
+        M.data[row]     *= v.x;
+        M.data[4 + row] *= v.y;
+        M.data[8 + row] *= v.z;
+    }
+}
+
+// M = M * R where R is a 3x3 rotation stored column-major in r[9]
+constexpr void postRotate3x3(mat4& M, const float* r) {
+    for (int row = 0; row < 4; ++row) {
+        float m0 = M.data[row], m1 = M.data[4 + row], m2 = M.data[8 + row];
+        M.data[row]     = m0 * r[0] + m1 * r[1] + m2 * r[2];
+        M.data[4 + row] = m0 * r[3] + m1 * r[4] + m2 * r[5];
+        M.data[8 + row] = m0 * r[6] + m1 * r[7] + m2 * r[8];
+    }
+}
+
+// rotations about a cardinal axis only mix two columns and need no normalize
+inline void postRotateX(mat4& M, float angle) {
+    float s, c;
+    sincos(angle, s, c);
+    for (int row = 0; row < 4; ++row) {
+        float m1 = M.data[4 + row], m2 = M.data[8 + row];
+        M.data[4 + row] = m1 * c + m2 * s;
+        M.data[8 + row] = m2 * c - m1 * s;
+    }
+}
+
+inline void postRotateY(mat4& M, float angle) {
+    float s, c;
+    sincos(angle, s, c);
+    for (int row = 0; row < 4; ++row) {
+        float m0 = M.data[row], m2 = M.data[8 + row];
+        M.data[row]     = m0 * c - m2 * s;
+        M.data[8 + row] = m0 * s + m2 * c;
+    }
+}
+
+inline void postRotateZ(mat4& M, float angle) {
+    float s, c;
+    sincos(angle, s, c);
+    for (int row = 0; row < 4; ++row) {
+        float m0 = M.data[row], m1 = M.data[4 + row];
+        M.data[row]     = m0 * c + m1 * s;
+        M.data[4 + row] = m1 * c - m0 * s;
+    }
+}
+
+// fill r[9] (column-major) with the rotation of angle radians about axis
+inline void rotation3x3(float* r, float angle, const vec3& axis) {
+    float s, c;
+    sincos(angle, s, c);
     float x = axis.x, y = axis.y, z = axis.z;
     // normalize
     float len = std::sqrt(x*x + y*y + z*z);
     if (len > 0.0f) { x /= len; y /= len; z /= len; }
 
+    r[0] = x*x*(1-c) + c;
+    r[1] = x*y*(1-c) + z*s;
+    r[2] = x*z*(1-c) - y*s;
+
+    r[3] = y*x*(1-c) - z*s;
+    r[4] = y*y*(1-c) + c;
+    r[5] = y*z*(1-c) + x*s;
+
+    r[6] = z*x*(1-c) + y*s;
+    r[7] = z*y*(1-c) - x*s;
+    r[8] = z*z*(1-c) + c;
+}
+
+// M = M * R(angle, axis), with a fast path for the cardinal axes
+inline void postRotate(mat4& M, float angle, const vec3& axis) {
+    if (axis.y == 0.0f && axis.z == 0.0f && axis.x > 0.0f) { postRotateX(M, angle); return; }
+    if (axis.x == 0.0f && axis.z == 0.0f && axis.y > 0.0f) { postRotateY(M, angle); return; }
+    if (axis.x == 0.0f && axis.y == 0.0f && axis.z > 0.0f) { postRotateZ(M, angle); return; }
+    float r[9];
+    rotation3x3(r, angle, axis);
+    postRotate3x3(M, r);
+}
+
+// M = M * T(pivot) * R(angle, axis) * T(-pivot), fused into one pass:
+// the right-hand side is [R | pivot - R*pivot]
+inline void postRotateAround(mat4& M, const vec3& pivot, float angle, const vec3& axis) {
+    float r[9];
+    if (axis.y == 0.0f && axis.z == 0.0f && axis.x > 0.0f) {
+        float s, c;
+        sincos(angle, s, c);
+        r[0] = 1; r[1] = 0; r[2] = 0;
+        r[3] = 0; r[4] = c; r[5] = s;
+        r[6] = 0; r[7] = -s; r[8] = c;
+    } else if (axis.x == 0.0f && axis.z == 0.0f && axis.y > 0.0f) {
+        float s, c;
+        sincos(angle, s, c);
+        r[0] = c; r[1] = 0; r[2] = -s;
+        r[3] = 0; r[4] = 1; r[5] = 0;
+        r[6] = s; r[7] = 0; r[8] = c;
+    } else if (axis.x == 0.0f && axis.y == 0.0f && axis.z > 0.0f) {
+        float s, c;
+        sincos(angle, s, c);
+        r[0] = c; r[1] = s; r[2] = 0;
+        r[3] = -s; r[4] = c; r[5] = 0;
+        r[6] = 0; r[7] = 0; r[8] = 1;
+    } else {
+        rotation3x3(r, angle, axis);
+    }
+    vec3 t = pivot - vec3(r[0] * pivot.x + r[3] * pivot.y + r[6] * pivot.z,
+                          r[1] * pivot.x + r[4] * pivot.y + r[7] * pivot.z,
+                          r[2] * pivot.x + r[5] * pivot.y + r[8] * pivot.z);
+    postTranslate(M, t);
+    postRotate3x3(M, r);
+}
+
+// translate: returns M * T (so transform = translate(transform, v) behaves like glm)
+constexpr mat4 translate(const mat4& M, const vec3& v) {
+    mat4 R = M;
+    postTranslate(R, v);
+    return R;
+}
+
+// rotate: angle in radians, axis normalized-ish
+inline mat4 rotate(const mat4& M, float angle, const vec3& axis) {
+    mat4 R = M;
+    postRotate(R, angle, axis);
+    return R;
+}
+
+// unit quaternion rotation (w + xi + yj + zk), same member order as glm
+struct quat {
+    float w, x, y, z;
+    constexpr quat() : w(1), x(0), y(0), z(0) {}
+    constexpr quat(float W, float X, float Y, float Z) : w(W), x(X), y(Y), z(Z) {}
+};
+
+// Hamilton product: applying the result rotates by b first, then by a
+constexpr quat operator*(const quat& a, const quat& b) {
+    return quat(a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z,
+                a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+                a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+                a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w);
+}
+
+// rotate a vector: v + w*t + u x t with t = 2 * (u x v)
+constexpr vec3 operator*(const quat& q, const vec3& v) {
+    float tx = 2.0f * (q.y*v.z - q.z*v.y);
+    float ty = 2.0f * (q.z*v.x - q.x*v.z);
+    float tz = 2.0f * (q.x*v.y - q.y*v.x);
+    return vec3(v.x + q.w*tx + (q.y*tz - q.z*ty),
+                v.y + q.w*ty + (q.z*tx - q.x*tz),
+                v.z + q.w*tz + (q.x*ty - q.y*tx));
+}
+
+constexpr float dot(const quat& a, const quat& b) {
+    return a.w*b.w + a.x*b.x + a.y*b.y + a.z*b.z;
+}
+
+constexpr quat conjugate(const quat& q) {
+    return quat(q.w, -q.x, -q.y, -q.z);
+}
+
+inline quat normalize(const quat& q) {
+    float len = std::sqrt(dot(q, q));
+    if (len > 0.0f)
+        return quat(q.w / len, q.x / len, q.y / len, q.z / len);
+    return quat();
+}
+
+// rotation of angle radians about axis (the axis does not need to be unit length)
+inline quat angleAxis(float angle, const vec3& axis) {
+    float x = axis.x, y = axis.y, z = axis.z;
+    float len2 = x*x + y*y + z*z;
+    if (len2 != 1.0f && len2 > 0.0f) {
+        float inv = 1.0f / std::sqrt(len2);
+        x *= inv; y *= inv; z *= inv;
+    }
+    float s, c;
+    sincos(angle * 0.5f, s, c);
+    return quat(c, x * s, y * s, z * s);
+}
+
+// normalized lerp along the shortest arc - cheap, not constant speed
+inline quat nlerp(const quat& a, const quat& b, float t) {
+    float k = dot(a, b) < 0.0f ? -t : t;
+    return normalize(quat(a.w + (b.w * k - a.w * t),
+                          a.x + (b.x * k - a.x * t),
+                          a.y + (b.y * k - a.y * t),
+                          a.z + (b.z * k - a.z * t)));
+}
+
+// spherical lerp along the shortest arc, falls back to nlerp when nearly parallel
+inline quat slerp(const quat& a, const quat& b, float t) {
+    float c = dot(a, b);
+    quat e = b;
+    if (c < 0.0f) { c = -c; e = quat(-b.w, -b.x, -b.y, -b.z); }
+    if (c > 0.9995f)
+        return nlerp(a, e, t);
+    float theta = std::acos(c);
+    float s = std::sin(theta);
+    float wa = std::sin((1.0f - t) * theta) / s;
+    float wb = std::sin(t * theta) / s;
+    return quat(a.w*wa + e.w*wb, a.x*wa + e.x*wb, a.y*wa + e.y*wb, a.z*wa + e.z*wb);
+}
+
+// 3x3 rotation of a unit quaternion, column-major in r[9] (no trig, 9 products)
+constexpr void rotation3x3(float* r, const quat& q) {
+    float xx = q.x*q.x, yy = q.y*q.y, zz = q.z*q.z;
+    float xy = q.x*q.y, xz = q.x*q.z, yz = q.y*q.z;
+    float wx = q.w*q.x, wy = q.w*q.y, wz = q.w*q.z;
+
+    r[0] = 1.0f - 2.0f*(yy + zz);
+    r[1] = 2.0f*(xy + wz);
+    r[2] = 2.0f*(xz - wy);
+
+    r[3] = 2.0f*(xy - wz);
+    r[4] = 1.0f - 2.0f*(xx + zz);
+    r[5] = 2.0f*(yz + wx);
+
+    r[6] = 2.0f*(xz + wy);
+    r[7] = 2.0f*(yz - wx);
+    r[8] = 1.0f - 2.0f*(xx + yy);
+}
+
+// rotation matrix of a unit quaternion
+constexpr mat4 mat4_cast(const quat& q) {
+    float r[9] = {};
+    rotation3x3(r, q);
     mat4 R(1.0f);
-    R.data[0] = x*x*(1-c) + c;
-    R.data[1] = x*y*(1-c) + z*s;
-    R.data[2] = x*z*(1-c) - y*s;
+    R.data[0] = r[0]; R.data[1] = r[1]; R.data[2]  = r[2];
+    R.data[4] = r[3]; R.data[5] = r[4]; R.data[6]  = r[5];
+    R.data[8] = r[6]; R.data[9] = r[7]; R.data[10] = r[8];
+    return R;
+}
+
+// M = M * R(q)
+constexpr void postRotate(mat4& M, const quat& q) {
+    float r[9] = {};
+    rotation3x3(r, q);
+    postRotate3x3(M, r);
+}
+
+// M = M * T(pivot) * R(q) * T(-pivot), fused like postRotateAround
+constexpr void postRotateAround(mat4& M, const vec3& pivot, const quat& q) {
+    postTranslate(M, pivot - q * pivot);
+    postRotate(M, q);
+}
+
+// ---------------------------------------------------------------------------
+// Batch transforms. Matrices are transposed into structure-of-arrays blocks
+// (one lane per matrix) so each kernel step handles GLM_SIMD_WIDTH transforms.
+// ---------------------------------------------------------------------------
+// GLM_SIMD_WIDTH matrices, element k of lane j at m[k][j]
+struct alignas(32) mat4Block {
+    float m[16][GLM_SIMD_WIDTH];
+};
+
+// GLM_SIMD_WIDTH points, one array per component
+struct alignas(32) vec3Block {
+    float x[GLM_SIMD_WIDTH], y[GLM_SIMD_WIDTH], z[GLM_SIMD_WIDTH];
+};
+
+// lanes past count are zero-filled so the kernels never read garbage
+inline void loadBlock(mat4Block& b, const mat4* src, int count) {
+    for (int k = 0; k < 16; ++k)
+        for (int j = 0; j < GLM_SIMD_WIDTH; ++j)
+            b.m[k][j] = j < count ? src[j].data[k] : 0.0f;
+}
+
+inline void storeBlock(const mat4Block& b, mat4* dst, int count) {
+    for (int j = 0; j < count; ++j)
+        for (int k = 0; k < 16; ++k)
+            dst[j].data[k] = b.m[k][j];
+}
+
+// R = A * B lane by lane
+inline void mulBlock(const mat4Block& A, const mat4Block& B, mat4Block& R) {
+    for (int col = 0; col < 4; ++col) {
+        const simdf b0 = simd_load(B.m[col*4 + 0]);
+        const simdf b1 = simd_load(B.m[col*4 + 1]);
+        const simdf b2 = simd_load(B.m[col*4 + 2]);
+        const simdf b3 = simd_load(B.m[col*4 + 3]);
+        for (int row = 0; row < 4; ++row) {
+            simdf r = simd_mul(simd_load(A.m[row]), b0);
+            r = simd_add(r, simd_mul(simd_load(A.m[4 + row]), b1));
+            r = simd_add(r, simd_mul(simd_load(A.m[8 + row]), b2));
+            r = simd_add(r, simd_mul(simd_load(A.m[12 + row]), b3));
+            simd_store(R.m[col*4 + row], r);
+        }
+    }
+}
+
+// R = A * B with the same B in every lane
+inline void mulBlock(const mat4Block& A, const mat4& B, mat4Block& R) {
+    for (int col = 0; col < 4; ++col) {
+        const simdf b0 = simd_set1(B.data[col*4 + 0]);
+        const simdf b1 = simd_set1(B.data[col*4 + 1]);
+        const simdf b2 = simd_set1(B.data[col*4 + 2]);
+        const simdf b3 = simd_set1(B.data[col*4 + 3]);
+        for (int row = 0; row < 4; ++row) {
+            simdf r = simd_mul(simd_load(A.m[row]), b0);
+            r = simd_add(r, simd_mul(simd_load(A.m[4 + row]), b1));
+            r = simd_add(r, simd_mul(simd_load(A.m[8 + row]), b2));
+            r = simd_add(r, simd_mul(simd_load(A.m[12 + row]), b3));
+            simd_store(R.m[col*4 + row], r);
+        }
+    }
+}
 
-    R.data[4] = y*x*(1-c) - z*s;
-    R.data[5] = y*y*(1-c) + c;
-    R.data[6] = y*z*(1-c) + x*s;
+// out[i] = A[i] * B
+inline void mulBatch(const mat4* A, const mat4& B, mat4* out, int n) {
+    mat4Block a, r;
+    for (int i = 0; i < n; i += GLM_SIMD_WIDTH) {
+        int count = n - i < GLM_SIMD_WIDTH ? n - i : GLM_SIMD_WIDTH;
+        loadBlock(a, A + i, count);
+        mulBlock(a, B, r);
+        storeBlock(r, out + i, count);
+    }
+}
 
-    R.data[8] = z*x*(1-c) + y*s;
-    R.data[9] = z*y*(1-c) - x*s;
-    R.data[10] = z*z*(1-c) + c;
+// out[i] = A[i] * B[i]
+inline void mulPairs(const mat4* A, const mat4* B, mat4* out, int n) {
+    mat4Block a, b, r;
+    for (int i = 0; i < n; i += GLM_SIMD_WIDTH) {
+        int count = n - i < GLM_SIMD_WIDTH ? n - i : GLM_SIMD_WIDTH;
+        loadBlock(a, A + i, count);
+        loadBlock(b, B + i, count);
+        mulBlock(a, b, r);
+        storeBlock(r, out + i, count);
+    }
+}
 
-    return M * R;
+// out[i] = M[i] * (p[i], 1), dropping w (the matrices are affine)
+inline void transformPoints(const mat4* M, const vec3* p, vec3* out, int n) {
+    mat4Block m;
+    vec3Block v, r;
+    for (int i = 0; i < n; i += GLM_SIMD_WIDTH) {
+        int count = n - i < GLM_SIMD_WIDTH ? n - i : GLM_SIMD_WIDTH;
+        loadBlock(m, M + i, count);
+        for (int j = 0; j < GLM_SIMD_WIDTH; ++j) {
+            v.x[j] = j < count ? p[i + j].x : 0.0f;
+            v.y[j] = j < count ? p[i + j].y : 0.0f;
+            v.z[j] = j < count ? p[i + j].z : 0.0f;
+        }
+        const simdf x = simd_load(v.x), y = simd_load(v.y), z = simd_load(v.z);
+        float* dst[3] = { r.x, r.y, r.z };
+        for (int row = 0; row < 3; ++row) {
+            simdf c = simd_load(m.m[12 + row]);
+            c = simd_add(c, simd_mul(simd_load(m.m[row]), x));
+            c = simd_add(c, simd_mul(simd_load(m.m[4 + row]), y));
+            c = simd_add(c, simd_mul(simd_load(m.m[8 + row]), z));
+            simd_store(dst[row], c);
+        }
+        for (int j = 0; j < count; ++j)
+            out[i + j] = vec3(r.x[j], r.y[j], r.z[j]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Inverses. Pick the cheapest one the matrix allows:
+//   inverseRigid  - rotation + translation only (R^T, -R^T t), ~20 flops
+//   inverseAffine - any 3x3 block + translation, cofactors of the 3x3 only
+//   inverse       - full 4x4 cofactor expansion, for projections
+// ---------------------------------------------------------------------------
+
+inline mat4 inverseRigid(const mat4& M) {
+    const float* m = M.data;
+    mat4 R(1.0f);
+    // transpose of the rotation block
+    R.data[0] = m[0]; R.data[1] = m[4]; R.data[2]  = m[8];
+    R.data[4] = m[1]; R.data[5] = m[5]; R.data[6]  = m[9];
+    R.data[8] = m[2]; R.data[9] = m[6]; R.data[10] = m[10];
+    R.data[12] = -(m[0] * m[12] + m[1] * m[13] + m[2]  * m[14]);
+    R.data[13] = -(m[4] * m[12] + m[5] * m[13] + m[6]  * m[14]);
+    R.data[14] = -(m[8] * m[12] + m[9] * m[13] + m[10] * m[14]);
+    return R;
+}
+
+inline mat4 inverseAffine(const mat4& M) {
+    const float* m = M.data;
+    vec3 c0(m[0], m[1], m[2]);
+    vec3 c1(m[4], m[5], m[6]);
+    vec3 c2(m[8], m[9], m[10]);
+    // rows of the inverse are the cross products of the columns / det
+    vec3 r0 = cross(c1, c2);
+    vec3 r1 = cross(c2, c0);
+    vec3 r2 = cross(c0, c1);
+    float det = dot(c0, r0);
+    float inv = det != 0.0f ? 1.0f / det : 0.0f;
+    r0 *= inv;
+    r1 *= inv;
+    r2 *= inv;
+    vec3 t(m[12], m[13], m[14]);
+
+    mat4 R(1.0f);
+    R.data[0] = r0.x; R.data[4] = r0.y; R.data[8]  = r0.z;
+    R.data[1] = r1.x; R.data[5] = r1.y; R.data[9]  = r1.z;
+    R.data[2] = r2.x; R.data[6] = r2.y; R.data[10] = r2.z;
+    R.data[12] = -dot(r0, t);
+    R.data[13] = -dot(r1, t);
+    R.data[14] = -dot(r2, t);
+    return R;
+}
+
+inline mat4 inverse(const mat4& M) {
+    const float* m = M.data;
+    float inv[16];
+
+    inv[0]  =  m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+    inv[4]  = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+    inv[8]  =  m[4]*m[9]*m[15]  - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+    inv[12] = -m[4]*m[9]*m[14]  + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+    inv[1]  = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+    inv[5]  =  m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+    inv[9]  = -m[0]*m[9]*m[15]  + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+    inv[13] =  m[0]*m[9]*m[14]  - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+    inv[2]  =  m[1]*m[6]*m[15]  - m[1]*m[7]*m[14]  - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7]  - m[13]*m[3]*m[6];
+    inv[6]  = -m[0]*m[6]*m[15]  + m[0]*m[7]*m[14]  + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7]  + m[12]*m[3]*m[6];
+    inv[10] =  m[0]*m[5]*m[15]  - m[0]*m[7]*m[13]  - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7]  - m[12]*m[3]*m[5];
+    inv[14] = -m[0]*m[5]*m[14]  + m[0]*m[6]*m[13]  + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6]  + m[12]*m[2]*m[5];
+    inv[3]  = -m[1]*m[6]*m[11]  + m[1]*m[7]*m[10]  + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7]   + m[9]*m[3]*m[6];
+    inv[7]  =  m[0]*m[6]*m[11]  - m[0]*m[7]*m[10]  - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7]   - m[8]*m[3]*m[6];
+    inv[11] = -m[0]*m[5]*m[11]  + m[0]*m[7]*m[9]   + m[4]*m[1]*m[11] - m[4]*m[3]*m[9]  - m[8]*m[1]*m[7]   + m[8]*m[3]*m[5];
+    inv[15] =  m[0]*m[5]*m[10]  - m[0]*m[6]*m[9]   - m[4]*m[1]*m[10] + m[4]*m[2]*m[9]  + m[8]*m[1]*m[6]   - m[8]*m[2]*m[5];
+
+    float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    float k = det != 0.0f ? 1.0f / det : 0.0f;
+    mat4 R;
+    for (int i = 0; i < 16; ++i)
+        R.data[i] = inv[i] * k;
+    return R;
+}
+
+// inverse-transpose of the upper 3x3, for transforming normals. When the
+// columns are orthogonal with the same length s (rotation * uniform scale)
+// it is just M / s^2; otherwise the cofactors are used.
+inline mat3 normalMatrix(const mat4& M) {
+    const float* m = M.data;
+    vec3 c0(m[0], m[1], m[2]);
+    vec3 c1(m[4], m[5], m[6]);
+    vec3 c2(m[8], m[9], m[10]);
+    float l0 = dot(c0, c0), l1 = dot(c1, c1), l2 = dot(c2, c2);
+    const float eps = 1e-5f * l0;
+    mat3 N(1.0f);
+    if (std::fabs(l0 - l1) <= eps && std::fabs(l0 - l2) <= eps
+        && std::fabs(dot(c0, c1)) <= eps && std::fabs(dot(c0, c2)) <= eps && std::fabs(dot(c1, c2)) <= eps) {
+        float k = l0 > 0.0f ? 1.0f / l0 : 0.0f;
+        for (int col = 0; col < 3; ++col)
+            for (int row = 0; row < 3; ++row)
+                N.data[col*3 + row] = m[col*4 + row] * k;
+        return N;
+    }
+    // (M^-1)^T has the cross products of the columns as its columns
+    vec3 n0 = cross(c1, c2);
+    vec3 n1 = cross(c2, c0);
+    vec3 n2 = cross(c0, c1);
+    float det = dot(c0, n0);
+    float k = det != 0.0f ? 1.0f / det : 0.0f;
+    n0 *= k;
+    n1 *= k;
+    n2 *= k;
+    N.data[0] = n0.x; N.data[1] = n0.y; N.data[2] = n0.z;
+    N.data[3] = n1.x; N.data[4] = n1.y; N.data[5] = n1.z;
+    N.data[6] = n2.x; N.data[7] = n2.y; N.data[8] = n2.z;
+    return N;
+}
+
+// ---------------------------------------------------------------------------
+// Culling primitives
+// ---------------------------------------------------------------------------
+
+// points p with dot(n, p) + d >= 0 are on the inner side
+struct plane {
+    vec3 n;
+    float d;
+};
+
+// left, right, bottom, top, near, far - normals point inwards
+struct frustum {
+    plane planes[6];
+};
+
+struct aabb {
+    vec3 min;
+    vec3 max;
+};
+
+// center, unit axes and half extents along each axis
+struct obb {
+    vec3 center;
+    vec3 axis[3];
+    vec3 half;
+};
+
+// planes of a view-projection matrix (Gribb/Hartmann), normalized so the
+// plane distances are in world units
+inline frustum extractFrustum(const mat4& vp) {
+    const float* m = vp.data;
+    // row r of the matrix is (m[r], m[4 + r], m[8 + r], m[12 + r])
+    const float sign[6] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+    frustum f;
+    for (int i = 0; i < 6; ++i) {
+        int r = i / 2;
+        float a = m[3]  + sign[i] * m[r];
+        float b = m[7]  + sign[i] * m[4 + r];
+        float c = m[11] + sign[i] * m[8 + r];
+        float d = m[15] + sign[i] * m[12 + r];
+        float len = std::sqrt(a*a + b*b + c*c);
+        if (len > 0.0f) { a /= len; b /= len; c /= len; d /= len; }
+        f.planes[i].n = vec3(a, b, c);
+        f.planes[i].d = d;
+    }
+    return f;
+}
+
+// bounds of model * [-0.5, 0.5]^3, the cube every part is drawn from
+inline aabb unitCubeBounds(const mat4& model) {
+    const float* m = model.data;
+    vec3 c(m[12], m[13], m[14]);
+    vec3 e(0.5f * (std::fabs(m[0]) + std::fabs(m[4]) + std::fabs(m[8])),
+           0.5f * (std::fabs(m[1]) + std::fabs(m[5]) + std::fabs(m[9])),
+           0.5f * (std::fabs(m[2]) + std::fabs(m[6]) + std::fabs(m[10])));
+    aabb b;
+    b.min = c - e;
+    b.max = c + e;
+    return b;
+}
+
+inline obb unitCubeOBB(const mat4& model) {
+    const float* m = model.data;
+    obb b;
+    b.center = vec3(m[12], m[13], m[14]);
+    for (int i = 0; i < 3; ++i) {
+        vec3 col(m[i*4], m[i*4 + 1], m[i*4 + 2]);
+        float len = length(col);
+        b.axis[i] = len > 0.0f ? col / len : col;
+        b.half[i] = 0.5f * len;
+    }
+    return b;
+}
+
+inline aabb toAABB(const obb& b) {
+    vec3 e;
+    for (int r = 0; r < 3; ++r)
+        e[r] = std::fabs(b.axis[0][r]) * b.half.x + std::fabs(b.axis[1][r]) * b.half.y + std::fabs(b.axis[2][r]) * b.half.z;
+    aabb a;
+    a.min = b.center - e;
+    a.max = b.center + e;
+    return a;
+}
+
+// conservative: false only when the box is fully outside one plane
+inline bool intersects(const frustum& f, const aabb& b) {
+    vec3 c = (b.min + b.max) * 0.5f;
+    vec3 e = (b.max - b.min) * 0.5f;
+    for (int i = 0; i < 6; ++i) {
+        const plane& p = f.planes[i];
+        float radius = std::fabs(p.n.x) * e.x + std::fabs(p.n.y) * e.y + std::fabs(p.n.z) * e.z;
+        if (dot(p.n, c) + p.d + radius < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+inline bool intersects(const frustum& f, const obb& b) {
+    for (int i = 0; i < 6; ++i) {
+        const plane& p = f.planes[i];
+        float radius = std::fabs(dot(p.n, b.axis[0])) * b.half.x
+                     + std::fabs(dot(p.n, b.axis[1])) * b.half.y
+                     + std::fabs(dot(p.n, b.axis[2])) * b.half.z;
+        if (dot(p.n, b.center) + p.d + radius < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+// visible[i] = 1 if boxes[i] touches the frustum, 0 otherwise. The boxes are
+// transposed to center/extent lanes and tested against the 6 planes
+// GLM_SIMD_WIDTH at a time.
+inline void cullBoxes(const frustum& f, const aabb* boxes, unsigned char* visible, int n) {
+    alignas(32) float cx[GLM_SIMD_WIDTH], cy[GLM_SIMD_WIDTH], cz[GLM_SIMD_WIDTH];
+    alignas(32) float ex[GLM_SIMD_WIDTH], ey[GLM_SIMD_WIDTH], ez[GLM_SIMD_WIDTH];
+    alignas(32) float out[GLM_SIMD_WIDTH];
+    const simdf zero = simd_set1(0.0f);
+    const simdf one = simd_set1(1.0f);
+    for (int i = 0; i < n; i += GLM_SIMD_WIDTH) {
+        int count = n - i < GLM_SIMD_WIDTH ? n - i : GLM_SIMD_WIDTH;
+        for (int j = 0; j < GLM_SIMD_WIDTH; ++j) {
+            const aabb& b = boxes[j < count ? i + j : i];
+            cx[j] = (b.min.x + b.max.x) * 0.5f;
+            cy[j] = (b.min.y + b.max.y) * 0.5f;
+            cz[j] = (b.min.z + b.max.z) * 0.5f;
+            ex[j] = (b.max.x - b.min.x) * 0.5f;
+            ey[j] = (b.max.y - b.min.y) * 0.5f;
+            ez[j] = (b.max.z - b.min.z) * 0.5f;
+        }
+        const simdf x = simd_load(cx), y = simd_load(cy), z = simd_load(cz);
+        const simdf hx = simd_load(ex), hy = simd_load(ey), hz = simd_load(ez);
+        simdf inside = one;
+        for (int k = 0; k < 6; ++k) {
+            const plane& p = f.planes[k];
+            simdf dist = simd_add(simd_mul(x, simd_set1(p.n.x)), simd_mul(y, simd_set1(p.n.y)));
+            dist = simd_add(dist, simd_add(simd_mul(z, simd_set1(p.n.z)), simd_set1(p.d)));
+            simdf radius = simd_add(simd_mul(hx, simd_set1(std::fabs(p.n.x))), simd_mul(hy, simd_set1(std::fabs(p.n.y))));
+            radius = simd_add(radius, simd_mul(hz, simd_set1(std::fabs(p.n.z))));
+            inside = simd_select(simd_cmpge(simd_add(dist, radius), zero), inside, zero);
+        }
+        simd_store(out, inside);
+        for (int j = 0; j < count; ++j)
+            visible[i + j] = out[j] != 0.0f ? 1 : 0;
+    }
 }
 
 // value_ptr returns pointer to first element in column-major layout
-inline const float* value_ptr(const mat4& m) {
+constexpr const float* value_ptr(const mat4& m) {
     return m.data;
 }
 
 // Convert degrees to radians
-inline float radians(float degrees) {
+constexpr float radians(float degrees) {
     // 180 degrees = π radians
     float radians = degrees * (PI / 180.0f);
     return radians;
@@ -151,32 +1025,10 @@ inline mat4 perspective(float fovy, float aspect, float znear, float zfar) {
     return Result;
 }
 
-inline vec3 normalize(const vec3 &v) {
-    float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-    if (len > 0.0f) {
-        return vec3(v.x / len, v.y / len, v.z / len);
-    }
-    return v;
-}
-
-inline float dot(const vec3 &a, const vec3 &b) {
-    return a.x * b.x + a.y * b.y + a.z * b.z;
-}
-
-inline vec3 cross(const vec3 &a, const vec3 &b) {
-    return vec3(
-        a.y * b.z - a.z * b.y,
-        a.z * b.x - a.x * b.z,
-        a.x * b.y - a.y * b.x
-    );
-}
-
-inline mat4 scale(const mat4& M, const vec3& v) {
-    mat4 S(1.0f);
-    S.data[0] = v.x;
-    S.data[5] = v.y;
-    S.data[10] = v.z;
-    return M * S;
+constexpr mat4 scale(const mat4& M, const vec3& v) {
+    mat4 R = M;
+    postScale(R, v);
+    return R;
 }
 
 inline mat4 lookAt(const vec3 &cam, const vec3 &center, const vec3 &up) {
@@ -7,30 +7,15 @@
 #include "khrplatform.h"
 #include <iostream>
 #include <vector>
+#include <cassert>
 #include "shader.h"
 // Minimal replacement for external GLM usage in this project
 #include "glm.hpp"
 #include "FileSystem.hpp"
 #include "stb_image.h"
 #include "Camera.hpp"
-#include <map>
 
 #define SIZE 1
-// Allow using glm::vec3 as key in ordered containers (std::map, std::set) by
-// providing a strict-weak-ordering comparator specialization for std::less.
-// This performs a lexicographic compare on (x, y, z).
-namespace std {
-    template<>
-    struct less<glm::vec3> {
-        bool operator()(glm::vec3 const& a, glm::vec3 const& b) const noexcept {
-            if (a.x < b.x) return true;
-            if (b.x < a.x) return false;
-            if (a.y < b.y) return true;
-            if (b.y < a.y) return false;
-            return a.z < b.z;
-        }
-    };
-}
 
 enum BodyPartType {
     HEAD,
@@ -45,7 +30,57 @@ enum BodyPartType {
     LEFT_LOWER_LEG, // leg
     WALL,
     CAP,
-    VISIERE
+    VISIERE,
+    BODY_PART_TYPE_COUNT
+};
+
+// the 12 edge midpoints of a part's box where other parts can attach
+// gauche/droite | bas/haut | arriere/avant
+enum AttachmentDir {
+    ATTACH_UP_RIGHT,
+    ATTACH_UP_BACK,
+    ATTACH_UP_LEFT,
+    ATTACH_UP_FRONT,
+    ATTACH_RIGHT_FRONT,
+    ATTACH_RIGHT_BACK,
+    ATTACH_LEFT_BACK,
+    ATTACH_LEFT_FRONT,
+    ATTACH_DOWN_RIGHT,
+    ATTACH_DOWN_BACK,
+    ATTACH_DOWN_LEFT,
+    ATTACH_DOWN_FRONT,
+    ATTACH_DIR_COUNT
+};
+
+// none/fixe/mobile -> 0 = n'existe pas, 1 = fixe, 2 = mobile
+enum AttachmentState : unsigned char {
+    ATTACH_NONE = 0,
+    ATTACH_FIXE = 1,
+    ATTACH_MOBILE = 2
+};
+
+// offset of each attachment point from the part position, indexed by AttachmentDir
+constexpr glm::vec3 ATTACHMENT_OFFSETS[ATTACH_DIR_COUNT] = {
+    {-1.0f,  1.0f,  0.0f},
+    { 0.0f,  1.0f, -1.0f},
+    { 1.0f,  1.0f,  0.0f},
+    { 0.0f,  1.0f,  1.0f},
+    {-1.0f,  0.0f,  1.0f},
+    {-1.0f,  0.0f, -1.0f},
+    { 1.0f,  0.0f, -1.0f},
+    { 1.0f,  0.0f,  1.0f},
+    {-1.0f, -1.0f,  0.0f},
+    { 0.0f, -1.0f, -1.0f},
+    { 1.0f, -1.0f,  0.0f},
+    { 0.0f, -1.0f,  1.0f},
+};
+
+// one state byte per direction, stored inline in the part (no heap nodes)
+struct attachmentSlots {
+    AttachmentState state[ATTACH_DIR_COUNT] = {};
+
+    AttachmentState operator[](AttachmentDir dir) const { return state[dir]; }
+    AttachmentState& operator[](AttachmentDir dir) { return state[dir]; }
 };
 
 class bodyPart {
@@ -57,15 +92,14 @@ class bodyPart {
         glm::vec3 initialPosition;
         BodyPartType partType;
         glm::vec3 scaleVec;
-        // dans la map: 0 = plus proche du tronc -> 1 = plus loin
-        // int none/fixe/mobile -> 0 = n'existe pas, 1 = fixe, 2 = mobile
-        std::map<glm::vec3, int> attachmentPoints;
+        // etat de chaque point d'attache, indexe par AttachmentDir
+        attachmentSlots attachmentPoints;
         float orientation;
 
         // angle de depart = 0
 
     public:
-        bodyPart(float x, float y, float z, BodyPartType partType, std::map<glm::vec3, int> attachmentPoints) : x(x), y(y), z(z), initialPosition(x, y, z), partType(partType), attachmentPoints(attachmentPoints), orientation(0.0f) { (void)orientation; }
+        bodyPart(float x, float y, float z, BodyPartType partType, const attachmentSlots& attachmentPoints) : x(x), y(y), z(z), initialPosition(x, y, z), partType(partType), attachmentPoints(attachmentPoints), orientation(0.0f) { (void)orientation; }
 
         float getX() const { return x; }
         float getY() const { return y; }
@@ -76,7 +110,14 @@ class bodyPart {
         glm::vec3 getPosition() { return glm::vec3(x, y, z); }
 
         // expose attachment points so other systems (e.g., renderer) can access them
-        const std::map<glm::vec3, int>& getAttachmentPoints() const { return attachmentPoints; }
+        const attachmentSlots& getAttachmentPoints() const { return attachmentPoints; }
+
+        AttachmentState getAttachmentState(AttachmentDir dir) const { return attachmentPoints[dir]; }
+        void setAttachmentState(AttachmentDir dir, AttachmentState state) { attachmentPoints[dir] = state; }
+        bool hasAttachment(AttachmentDir dir) const { return attachmentPoints[dir] != ATTACH_NONE; }
+
+        // world position of an attachment point, relative to the part position
+        glm::vec3 getAttachmentPoint(AttachmentDir dir) const { return glm::vec3(x, y, z) + ATTACHMENT_OFFSETS[dir]; }
 
         int operator==(const bodyPart& other) const {
             return (partType == other.partType);
@@ -91,8 +132,17 @@ class bodyPart {
 class body {
     private:
         std::vector<bodyPart> parts;
+        // index in parts of the first part of each type, -1 if there is none
+        int typeIndex[BODY_PART_TYPE_COUNT];
     public:
+        body() {
+            for (int i = 0; i < BODY_PART_TYPE_COUNT; ++i)
+                typeIndex[i] = -1;
+        }
+
         void addPart(const bodyPart& part) {
+            if (typeIndex[part.getPartType()] < 0)
+                typeIndex[part.getPartType()] = static_cast<int>(parts.size());
             parts.push_back(part);
         }
 
@@ -100,33 +150,18 @@ class body {
             return parts;
         }
 
-        std::map<glm::vec3, int> getAttachmentPoints(int type) const {
-            switch (type) {
-                case HEAD:
-                    return parts[0].getAttachmentPoints();
-                case TORSO:
-                    return parts[1].getAttachmentPoints();
-                case RIGHT_UPPER_ARM:
-                    return parts[2].getAttachmentPoints();
-                case RIGHT_LOWER_ARM:
-                    return parts[3].getAttachmentPoints();
-                case LEFT_UPPER_ARM:
-                    return parts[4].getAttachmentPoints();
-                case LEFT_LOWER_ARM:
-                    return parts[5].getAttachmentPoints();
-                case RIGHT_THIGH:
-                    return parts[6].getAttachmentPoints();
-                case RIGHT_LOWER_LEG:
-                    return parts[7].getAttachmentPoints();
-                case LEFT_THIGH:
-                    return parts[8].getAttachmentPoints();
-                case LEFT_LOWER_LEG:
-                    return parts[9].getAttachmentPoints();
-                case CAP:
-                    return parts[10].getAttachmentPoints();
-                default:
-                    return {};
-            }
+        // O(1) lookups through the type table, -1 / false when the body has no such part
+        int getPartIndex(BodyPartType type) const { return typeIndex[type]; }
+        bool hasPart(BodyPartType type) const { return typeIndex[type] >= 0; }
+
+        const bodyPart& getPart(BodyPartType type) const {
+            assert(hasPart(type) && "body has no part of this type");
+            return parts[typeIndex[type]];
+        }
+
+        const attachmentSlots& getAttachmentPoints(BodyPartType type) const {
+            static const attachmentSlots none;
+            return hasPart(type) ? parts[typeIndex[type]].getAttachmentPoints() : none;
         }
 
         void draw_cap(Shader& ourShader) {
@@ -0,0 +1,63 @@
+#ifndef JOBS_HPP
+#define JOBS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads fed by parallelFor(). Every thread owns a job
+// queue: it pops its own newest jobs first and, once that runs dry, steals
+// the oldest jobs of the others, so uneven batches even out on their own.
+// The calling thread counts as one of the threads and works too.
+class JobPool
+{
+    private:
+        struct Job
+        {
+            void (*run)(const void* context, int begin, int end);
+            const void* context;
+            int begin;
+            int end;
+        };
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque<Job> jobs;
+        };
+        std::vector<std::unique_ptr<Queue>> _queues; // one per thread, 0 is the caller's
+        std::vector<std::thread> _workers;
+        std::mutex _wakeLock;
+        std::condition_variable _wake;
+        unsigned int _round; // bumped, under _wakeLock, each time jobs are queued
+        bool _quit;
+        std::atomic<int> _pending; // jobs of the current parallelFor not finished yet
+
+        void dispatch(int count, int batch, void (*run)(const void*, int, int), const void* context);
+        bool runOne(int self);
+        void workerLoop(int self);
+
+    public:
+        // threads includes the caller; 0 uses every hardware thread
+        explicit JobPool(int threads = 0);
+        ~JobPool();
+        JobPool(const JobPool&) = delete;
+        JobPool& operator=(const JobPool&) = delete;
+
+        int threadCount() const { return static_cast<int>(_queues.size()); }
+
+        // calls f(begin, end) on consecutive ranges of at most batch items
+        // covering [0, count), spread over every thread; returns once all are done
+        template <typename F>
+        void parallelFor(int count, int batch, const F& f)
+        {
+            dispatch(count, batch, [](const void* context, int begin, int end) {
+                (*static_cast<const F*>(context))(begin, end);
+            }, &f);
+        }
+};
+
+#endif
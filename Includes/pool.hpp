@@ -0,0 +1,47 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include "animation.hpp"
+
+// names a character in a CharacterPool. The generation changes every time
+// the slot is freed, so a handle kept past despawn() stops resolving instead
+// of aliasing whoever reuses the slot. Generation 0 is never live.
+struct CharacterHandle
+{
+    unsigned int index = 0;
+    unsigned int generation = 0;
+};
+
+// fixed-capacity storage for characters: every slot is allocated up front,
+// spawn() pops a free slot and despawn() pushes it back, so spawning and
+// despawning a crowd never touches the heap once the pool exists.
+class CharacterPool
+{
+    private:
+        std::vector<Animator> _slots;
+        std::vector<unsigned int> _generations;
+        std::vector<int> _free; // stack of free slot indices
+        std::vector<int> _live; // dense list of live slot indices
+        std::vector<int> _livePos; // position of each live slot in _live
+
+    public:
+        explicit CharacterPool(int capacity);
+
+        // returns an invalid handle (generation 0) when the pool is full
+        CharacterHandle spawn(const glm::mat4& root, Animations state = NONE);
+        // false when the handle is stale or invalid
+        bool despawn(CharacterHandle handle);
+
+        bool isAlive(CharacterHandle handle) const;
+        // nullptr when the handle is stale or invalid
+        Animator* get(CharacterHandle handle);
+        const Animator* get(CharacterHandle handle) const;
+
+        int capacity() const { return static_cast<int>(_slots.size()); }
+        // live characters, 0 .. size() - 1, in no particular order
+        int size() const { return static_cast<int>(_live.size()); }
+        Animator& getLive(int i) { return _slots[_live[i]]; }
+        const Animator& getLive(int i) const { return _slots[_live[i]]; }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef POSE_HPP
+#define POSE_HPP
+
+#include "rig.hpp"
+
+// local pose of every joint, on top of its bind offset from the rig
+struct Pose
+{
+    glm::quat rot[JOINT_COUNT];
+    glm::vec3 trans[JOINT_COUNT];
+};
+
+// per-joint blend of two poses: nlerp of the rotations, lerp of the translations
+void lerpPose(const Pose& a, const Pose& b, float t, Pose& out);
+
+// set of joints, one bit per RigJoint
+typedef unsigned int JointMask;
+constexpr JointMask jointBit(int joint) { return 1u << joint; }
+constexpr JointMask MASK_ALL = (1u << JOINT_COUNT) - 1;
+constexpr JointMask MASK_LEFT_ARM = jointBit(JOINT_LEFT_SHOULDER) | jointBit(JOINT_LEFT_ELBOW);
+constexpr JointMask MASK_RIGHT_ARM = jointBit(JOINT_RIGHT_SHOULDER) | jointBit(JOINT_RIGHT_ELBOW);
+constexpr JointMask MASK_ARMS = MASK_LEFT_ARM | MASK_RIGHT_ARM;
+constexpr JointMask MASK_UPPER_BODY = jointBit(JOINT_SPINE) | MASK_ARMS;
+constexpr JointMask MASK_LEGS = jointBit(JOINT_RIGHT_HIP) | jointBit(JOINT_RIGHT_KNEE)
+                                | jointBit(JOINT_LEFT_HIP) | jointBit(JOINT_LEFT_KNEE);
+
+// current key of every track of a PackedPoses, kept per playing instance:
+// rotation tracks first, then translation tracks
+struct PackedCursor
+{
+    int key[JOINT_COUNT * 2] = {};
+
+    void reset()
+    {
+        for (int& k : key)
+            k = 0;
+    }
+};
+
+// a table of evenly spaced poses stored compressed. Every joint has a
+// rotation track and a translation track holding only the keys that linear
+// interpolation cannot rebuild within the error bounds. Each key is 48 bits:
+// rotations as smallest-three quaternions (2-bit index of the dropped
+// component, three 15-bit components), translations as three 16-bit axes.
+// Components are quantized over the range the track actually covers.
+class PackedPoses
+{
+    private:
+        struct Track
+        {
+            int first = 0; // index of the first key in _keys
+            int count = 0;
+            // component c decodes as base[c] + quantized * scale[c]
+            // (w, x, y, z for rotations, x, y, z for translations)
+            float base[4] = {};
+            float scale[4] = {};
+        };
+        // decoded value of tracks with a single key, read without decoding
+        glm::quat _rotHeld[JOINT_COUNT];
+        glm::vec3 _transHeld[JOINT_COUNT];
+        Track _rot[JOINT_COUNT];
+        Track _trans[JOINT_COUNT];
+        int _frameCount = 0;
+        // frame number and value of every key, track after track: 8 bytes a
+        // key, so a search and the decode after it read the same cache lines
+        struct Key
+        {
+            unsigned short frame;
+            unsigned short words[3];
+        };
+        std::vector<Key> _keys;
+
+    public:
+        // packs frames[0..frameCount]. Keys are dropped while every frame
+        // they cover stays within rotError radians and transError units of
+        // its original, quantization included
+        void pack(const Pose* frames, int frameCount, float rotError, float transError);
+        bool isPacked() const { return _frameCount > 0; }
+        // pose at fractional frame f in [0, frameCount], written for the joints
+        // in mask only. cursor is where the previous sample of this instance
+        // left each track: played forward, a track steps to its next key
+        // instead of searching for it
+        void sample(float f, PackedCursor& cursor, Pose& pose, JointMask mask = MASK_ALL) const;
+        int keyCount() const { return static_cast<int>(_keys.size()); }
+        size_t byteSize() const;
+};
+
+#endif
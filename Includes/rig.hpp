@@ -0,0 +1,283 @@
+#ifndef RIG_HPP
+#define RIG_HPP
+
+#include "include.hpp"
+#include <string>
+#include <type_traits>
+
+// Bind pose of the character, computed at compile time. main() builds the
+// body from RIG_PARTS and the animator poses the joints of RIG_JOINTS, so
+// nothing here is re-derived at runtime.
+
+// up, down, right, left, front, back
+// left/right | up/down | front/back
+constexpr float HEAD_SCALE = 1.0f;
+constexpr float TORSO_SCALE = 3.0f; // "corp = 3"
+constexpr float ARM_SCALE = 2.0f;   // "bras = 2"
+constexpr float LEG_SCALE = 2.0f;   // "jambe = 2"
+constexpr float BASE = float(SIZE); // unit cube size
+
+// half extents of each part (world units)
+constexpr float HEAD_HALF = (0.5f * HEAD_SCALE * BASE) - (BASE / 4);
+constexpr float TORSO_HALF = 0.5f * TORSO_SCALE * BASE;
+constexpr float ARM_HALF = 0.5f * ARM_SCALE * BASE;
+constexpr float LEG_HALF = 0.5f * LEG_SCALE * BASE;
+
+// head center at y = 0.0
+constexpr glm::vec3 HEAD_CENTER = {0.0f, 0.0f, 0.0f};
+// torso directly below the head so they touch: headBottom == torsoTop
+constexpr glm::vec3 TORSO_CENTER = {0.0f, HEAD_CENTER.y - (HEAD_HALF + TORSO_HALF), 0.0f};
+// upper-arm top aligned with torso top, arms directly adjacent to the torso
+constexpr float ARM_ATTACH_Y = TORSO_CENTER.y + TORSO_HALF - ARM_HALF;
+constexpr float ARM_OFFSET_X = TORSO_HALF + ARM_HALF - (BASE * 0.5f);
+constexpr glm::vec3 RIGHT_UPPER_ARM_CENTER = {-ARM_OFFSET_X, ARM_ATTACH_Y, 0.0f};
+constexpr glm::vec3 LEFT_UPPER_ARM_CENTER = {ARM_OFFSET_X, ARM_ATTACH_Y, 0.0f};
+// lower arms below upper arms so they touch
+constexpr glm::vec3 RIGHT_LOWER_ARM_CENTER = {RIGHT_UPPER_ARM_CENTER.x, RIGHT_UPPER_ARM_CENTER.y - (ARM_HALF + ARM_HALF), 0.0f};
+constexpr glm::vec3 LEFT_LOWER_ARM_CENTER = {LEFT_UPPER_ARM_CENTER.x, LEFT_UPPER_ARM_CENTER.y - (ARM_HALF + ARM_HALF), 0.0f};
+// legs attach under the torso at +/-0.5
+constexpr float LEG_ATTACH_X = 0.5f * BASE;
+constexpr glm::vec3 RIGHT_THIGH_CENTER = {-LEG_ATTACH_X, TORSO_CENTER.y - (TORSO_HALF + LEG_HALF), 0.0f};
+constexpr glm::vec3 LEFT_THIGH_CENTER = {LEG_ATTACH_X, TORSO_CENTER.y - (TORSO_HALF + LEG_HALF), 0.0f};
+constexpr glm::vec3 RIGHT_LOWER_LEG_CENTER = {RIGHT_THIGH_CENTER.x, RIGHT_THIGH_CENTER.y - (LEG_HALF + LEG_HALF), 0.0f};
+constexpr glm::vec3 LEFT_LOWER_LEG_CENTER = {LEFT_THIGH_CENTER.x, LEFT_THIGH_CENTER.y - (LEG_HALF + LEG_HALF), 0.0f};
+constexpr glm::vec3 CAP_CENTER = {0.0f, HEAD_CENTER.y + (BASE / 2), 0.0f};
+constexpr glm::vec3 VISIERE_CENTER = {0.0f, HEAD_CENTER.y + (BASE / 4), BASE - (BASE / 4)};
+
+// skeleton, parents before children. A joint's world matrix is its parent's
+// world matrix times T(bind offset + pose translation) * R(pose rotation).
+// Adding a joint (neck, wrist, ankle) is one more row here, in RIG_JOINTS and
+// in JOINT_CHANNELS (animation.cpp), plus the AnimAngles channel that drives
+// it. Poses are sized by JOINT_COUNT, so rig files can move and re-parent
+// these joints but not add new ones.
+enum RigJoint
+{
+    JOINT_ROOT, // torso base, carries the whole-body offset
+    JOINT_SPINE, // torso lean; head, cap and visiere follow it
+    JOINT_RIGHT_SHOULDER,
+    JOINT_RIGHT_ELBOW,
+    JOINT_LEFT_SHOULDER,
+    JOINT_LEFT_ELBOW,
+    JOINT_RIGHT_HIP, // legs hang off the root, not the spine
+    JOINT_RIGHT_KNEE,
+    JOINT_LEFT_HIP,
+    JOINT_LEFT_KNEE,
+    JOINT_COUNT
+};
+
+struct PartLayout
+{
+    // a BodyPartType, stored as a plain int: the layout is also read back from
+    // the binary cache, and any value must be range checked before it is an enum
+    int type;
+    glm::vec3 center;
+    glm::vec3 size;
+    int parent; // index in RIG_PARTS, -1 for the root
+    int joint; // RigJoint that moves the part
+    // attachment states indexed by AttachmentDir: 0 = none, 1 = fixe, 2 = mobile
+    int attachments[ATTACH_DIR_COUNT];
+};
+
+// same order as the parts are added to the body
+constexpr PartLayout RIG_PARTS[] = {
+    {HEAD, HEAD_CENTER, {HEAD_SCALE * BASE, BASE / 2, BASE}, 1, JOINT_SPINE,
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2}},
+    {TORSO, TORSO_CENTER, {TORSO_SCALE * BASE, TORSO_SCALE * BASE, BASE}, -1, JOINT_SPINE,
+        {2, 0, 2, 2, 0, 0, 0, 0, 0, 0, 0, 2}},
+    {RIGHT_UPPER_ARM, RIGHT_UPPER_ARM_CENTER, {BASE, ARM_SCALE * BASE, BASE}, 1, JOINT_RIGHT_SHOULDER,
+        {0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 2}},
+    {RIGHT_LOWER_ARM, RIGHT_LOWER_ARM_CENTER, {BASE, ARM_SCALE * BASE, BASE}, 2, JOINT_RIGHT_ELBOW,
+        {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {LEFT_UPPER_ARM, LEFT_UPPER_ARM_CENTER, {BASE, ARM_SCALE * BASE, BASE}, 1, JOINT_LEFT_SHOULDER,
+        {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2}},
+    {LEFT_LOWER_ARM, LEFT_LOWER_ARM_CENTER, {BASE, ARM_SCALE * BASE, BASE}, 4, JOINT_LEFT_ELBOW,
+        {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {RIGHT_THIGH, RIGHT_THIGH_CENTER, {BASE, LEG_SCALE * BASE, BASE}, 1, JOINT_RIGHT_HIP,
+        {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2}},
+    {RIGHT_LOWER_LEG, RIGHT_LOWER_LEG_CENTER, {BASE, LEG_SCALE * BASE, BASE}, 6, JOINT_RIGHT_KNEE,
+        {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {LEFT_THIGH, LEFT_THIGH_CENTER, {BASE, LEG_SCALE * BASE, BASE}, 1, JOINT_LEFT_HIP,
+        {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2}},
+    {LEFT_LOWER_LEG, LEFT_LOWER_LEG_CENTER, {BASE, LEG_SCALE * BASE, BASE}, 8, JOINT_LEFT_KNEE,
+        {0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0}},
+    {CAP, CAP_CENTER, {BASE, HEAD_SCALE * (BASE / 2), BASE}, 0, JOINT_SPINE,
+        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1}},
+    {VISIERE, VISIERE_CENTER, {BASE, 0.1f, BASE / 2}, 10, JOINT_SPINE,
+        {1, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0, 0}},
+};
+
+constexpr int RIG_PART_COUNT = sizeof(RIG_PARTS) / sizeof(RIG_PARTS[0]);
+
+// index of the first part of a type in RIG_PARTS, -1 if there is none
+constexpr int rigPartIndex(BodyPartType type)
+{
+    for (int i = 0; i < RIG_PART_COUNT; ++i)
+        if (RIG_PARTS[i].type == type)
+            return i;
+    return -1;
+}
+
+// joint pivot of a part: top (proximal) or bottom (distal) of the box.
+// upper arms pivot on their inner edge so they swing around the shoulder.
+constexpr glm::vec3 rigPivot(BodyPartType type, bool proximal)
+{
+    const PartLayout& p = RIG_PARTS[rigPartIndex(type)];
+    float pivotY = proximal ? p.center.y + p.size.y * 0.5f : p.center.y - p.size.y * 0.5f;
+    float pivotX = p.center.x;
+    if (type == RIGHT_UPPER_ARM || type == LEFT_UPPER_ARM)
+        pivotX = p.center.x - (p.center.x > 0.0f ? 1.0f : -1.0f) * p.size.x * 0.5f;
+    return glm::vec3(pivotX, pivotY, 0.0f);
+}
+
+struct JointLayout
+{
+    int parent; // index in RIG_JOINTS, -1 for the root
+    glm::vec3 pivot; // bind-pose position in body space
+};
+
+constexpr JointLayout RIG_JOINTS[JOINT_COUNT] = {
+    {-1, rigPivot(TORSO, false)},
+    {JOINT_ROOT, rigPivot(TORSO, false)},
+    {JOINT_SPINE, rigPivot(RIGHT_UPPER_ARM, true)},
+    {JOINT_RIGHT_SHOULDER, rigPivot(RIGHT_UPPER_ARM, false)},
+    {JOINT_SPINE, rigPivot(LEFT_UPPER_ARM, true)},
+    {JOINT_LEFT_SHOULDER, rigPivot(LEFT_UPPER_ARM, false)},
+    {JOINT_ROOT, rigPivot(RIGHT_THIGH, true)},
+    {JOINT_RIGHT_HIP, rigPivot(RIGHT_THIGH, false)},
+    {JOINT_ROOT, rigPivot(LEFT_THIGH, true)},
+    {JOINT_LEFT_HIP, rigPivot(LEFT_THIGH, false)},
+};
+
+// a complete rig as plain data: the parts to build a body from and the joint
+// pivots the animator poses. Trivially copyable so the binary cache is the
+// struct itself, loaded with a single read.
+constexpr int RIG_MAX_PARTS = 32;
+
+struct RigDef
+{
+    int partCount;
+    PartLayout parts[RIG_MAX_PARTS];
+    JointLayout joints[JOINT_COUNT];
+};
+
+static_assert(std::is_trivially_copyable<RigDef>::value, "RigDef is stored as raw bytes");
+
+constexpr RigDef defaultRig()
+{
+    RigDef r{};
+    r.partCount = RIG_PART_COUNT;
+    for (int i = 0; i < RIG_PART_COUNT; ++i)
+        r.parts[i] = RIG_PARTS[i];
+    for (int j = 0; j < JOINT_COUNT; ++j)
+        r.joints[j] = RIG_JOINTS[j];
+    return r;
+}
+
+// built-in rig, used when no rig file is given or it fails to load
+constexpr RigDef RIG_DEFAULT = defaultRig();
+
+// local bind translation of a joint: its pivot relative to its parent's
+constexpr glm::vec3 rigJointOffset(const RigDef& rig, int joint)
+{
+    const JointLayout& j = rig.joints[joint];
+    return j.parent < 0 ? j.pivot : j.pivot - rig.joints[j.parent].pivot;
+}
+
+// joint that moves each part type, -1 for types the rig does not have
+struct RigTypeJoints
+{
+    int joint[BODY_PART_TYPE_COUNT];
+};
+
+constexpr RigTypeJoints rigTypeJoints(const RigDef& rig)
+{
+    RigTypeJoints t{};
+    for (int type = 0; type < BODY_PART_TYPE_COUNT; ++type) {
+        t.joint[type] = -1;
+        for (int i = 0; i < rig.partCount; ++i)
+            if (rig.parts[i].type == type) {
+                t.joint[type] = rig.parts[i].joint;
+                break;
+            }
+    }
+    return t;
+}
+
+constexpr bool rigJointsSorted(const RigDef& rig)
+{
+    for (int i = 0; i < JOINT_COUNT; ++i)
+        if (rig.joints[i].parent >= i)
+            return false;
+    return true;
+}
+
+static_assert(rigJointsSorted(RIG_DEFAULT), "joints must come after their parent");
+static_assert(RIG_PARTS[1].type == TORSO && RIG_PARTS[1].parent == -1, "torso is the root of the rig");
+
+// names used by the rig text format, in enum order
+constexpr const char* BODY_PART_TYPE_NAMES[BODY_PART_TYPE_COUNT] = {
+    "HEAD", "TORSO", "RIGHT_UPPER_ARM", "RIGHT_LOWER_ARM", "LEFT_UPPER_ARM", "LEFT_LOWER_ARM",
+    "RIGHT_THIGH", "LEFT_THIGH", "RIGHT_LOWER_LEG", "LEFT_LOWER_LEG", "WALL", "CAP", "VISIERE"
+};
+
+constexpr const char* RIG_JOINT_NAMES[JOINT_COUNT] = {
+    "ROOT", "SPINE", "RIGHT_SHOULDER", "RIGHT_ELBOW", "LEFT_SHOULDER", "LEFT_ELBOW",
+    "RIGHT_HIP", "RIGHT_KNEE", "LEFT_HIP", "LEFT_KNEE"
+};
+
+// bump when RigDef or any struct inside it changes layout
+constexpr unsigned int RIG_BINARY_VERSION = 1;
+
+// rig files (rigs/*.rig) are text for authoring; loadRig compiles them to a
+// binary cache next to the text (<path>b) and reuses that cache until the
+// text is newer or the cache version is stale. Errors are printed, and the
+// functions return false.
+bool loadRig(const std::string& textPath, RigDef& rig);
+bool parseRigText(const std::string& textPath, RigDef& rig);
+bool readRigBinary(const std::string& binaryPath, RigDef& rig);
+bool writeRigBinary(const std::string& binaryPath, const RigDef& rig);
+
+// fill colour of each part type
+constexpr glm::vec3 RIG_PART_COLORS[BODY_PART_TYPE_COUNT] = {
+    {1.0f, 187.0f/255.0f, 119.0f/255.0f}, // HEAD
+    {0.0f, 238.0f/255.0f, 221.0f/255.0f}, // TORSO
+    {1.0f, 187.0f/255.0f, 119.0f/255.0f}, // RIGHT_UPPER_ARM
+    {1.0f, 187.0f/255.0f, 119.0f/255.0f}, // RIGHT_LOWER_ARM
+    {1.0f, 187.0f/255.0f, 119.0f/255.0f}, // LEFT_UPPER_ARM
+    {1.0f, 187.0f/255.0f, 119.0f/255.0f}, // LEFT_LOWER_ARM
+    {0.0f, 136.0f/255.0f, 204.0f/255.0f}, // RIGHT_THIGH
+    {0.0f, 136.0f/255.0f, 204.0f/255.0f}, // LEFT_THIGH
+    {0.0f, 136.0f/255.0f, 204.0f/255.0f}, // RIGHT_LOWER_LEG
+    {0.0f, 136.0f/255.0f, 204.0f/255.0f}, // LEFT_LOWER_LEG
+    {0.9f, 0.9f, 0.9f},                   // WALL
+    {0.0f, 0.0f, 0.0f},                   // CAP
+    {1.0f, 0.0f, 0.0f},                   // VISIERE
+};
+
+// immutable data every instance of a character shares: the body, the joint
+// each part follows and the part's T * S relative to that joint's pivot.
+// Per-instance state (Animator) only holds a pose, so a crowd costs one Rig
+// plus one small pose record per character.
+class Rig
+{
+    private:
+        RigDef _def;
+        body _body;
+        RigTypeJoints _typeJoints;
+        std::vector<int> _partJoint; // -1 for parts no joint moves
+        std::vector<glm::mat4> _partLocal;
+
+    public:
+        explicit Rig(const RigDef& def);
+
+        const RigDef& getDef() const { return _def; }
+        const body& getBody() const { return _body; }
+        const JointLayout& getJoint(int joint) const { return _def.joints[joint]; }
+        int getPartCount() const { return static_cast<int>(_partJoint.size()); }
+        int getPartJoint(int part) const { return _partJoint[part]; }
+        int getTypeJoint(BodyPartType type) const { return _typeJoints.joint[type]; }
+        const glm::mat4* getPartLocals() const { return _partLocal.data(); }
+        const glm::vec3& getColor(BodyPartType type) const { return RIG_PART_COLORS[type]; }
+};
+
+#endif
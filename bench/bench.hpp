@@ -0,0 +1,45 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+// timing shared by the benchmarks
+
+#include <chrono>
+
+// wall time of the timed sections, summed over every start() / stop() pair
+class BenchTimer
+{
+    private:
+        std::chrono::steady_clock::time_point _start;
+        double _ns = 0.0;
+
+    public:
+        void start() { _start = std::chrono::steady_clock::now(); }
+        void stop()
+        {
+            _ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _start).count();
+        }
+        double ns() const { return _ns; }
+};
+
+// average nanoseconds per call of f(i), for i in [0, count)
+template <typename F>
+double nsPerCall(int count, F f)
+{
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i)
+        f(i);
+    timer.stop();
+    return timer.ns() / count;
+}
+
+// every store to a volatile is kept, so the work behind keep()'s value cannot
+// be dropped
+inline volatile float benchSink;
+
+inline void keep(float value)
+{
+    benchSink = value;
+}
+
+#endif
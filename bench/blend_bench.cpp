@@ -0,0 +1,66 @@
+// cost of Animator::evaluate on one clip, during a cross-fade between two
+// playing clips, and during a fade out of a frozen pose (a fade cut off
+// midway), both on evaluated and on baked clips
+#include "animation.hpp"
+#include "bench.hpp"
+#include <cstdio>
+#include <vector>
+
+enum FadeCase
+{
+    FADE_NONE,
+    FADE_CLIPS,
+    FADE_FROZEN
+};
+
+static double nsPerEvaluate(const Rig& rig, const BakedPoses* baked, FadeCase fade)
+{
+    const int count = 256, steps = 400;
+    const float step = 1.0f / 60.0f;
+    std::vector<Animator> animators(count);
+    for (int i = 0; i < count; ++i) {
+        Animator& a = animators[i];
+        a.setState(WALKING, 0.0f);
+        a.update(i * 0.01f);
+        a.evaluate(rig, baked);
+    }
+    BenchTimer timer;
+    for (int s = 0; s < steps; ++s) {
+        // restart the fade before it ends, so every timed evaluate blends
+        if (s % 10 == 0)
+            for (Animator& a : animators) {
+                if (fade == FADE_NONE)
+                    continue;
+                a.setState(s % 20 ? WAVING : WALKING, 1.0f);
+                if (fade == FADE_FROZEN) {
+                    a.evaluate(rig, baked);
+                    a.setState(s % 20 ? WALKING : WAVING, 1.0f);
+                }
+            }
+        for (Animator& a : animators)
+            a.update(step);
+        timer.start();
+        for (Animator& a : animators)
+            a.evaluate(rig, baked);
+        timer.stop();
+    }
+    for (const Animator& a : animators)
+        keep(a.getJointWorld()[JOINT_COUNT - 1].data[12]);
+    return timer.ns() / (double(count) * steps);
+}
+
+int main()
+{
+    const Rig rig(RIG_DEFAULT);
+    BakedPoses baked;
+    baked.bake(60.0f);
+    const BakedPoses* sources[] = {nullptr, &baked};
+    for (const BakedPoses* source : sources) {
+        const double none = nsPerEvaluate(rig, source, FADE_NONE);
+        const double clips = nsPerEvaluate(rig, source, FADE_CLIPS);
+        const double frozen = nsPerEvaluate(rig, source, FADE_FROZEN);
+        std::printf("evaluate (%s): one clip %.0f ns, fading clips %.0f ns (%.2fx), fading frozen pose %.0f ns (%.2fx)\n",
+                    source ? "baked" : "evaluated", none, clips, clips / none, frozen, frozen / none);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+// JUMPING sampled through the keyframe engine against the hand-written
+// phase chain it replaced
+#include "animation.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static float phaseProgress(float p, float start, float end)
+{
+    float s = (p - start) / (end - start);
+    return easeInOut(std::min(std::max(s, 0.0f), 1.0f));
+}
+
+static float mix(float a, float b, float s)
+{
+    return a + (b - a) * s;
+}
+
+// the pre-clip jump: knee, leg, arm, elbow, torso, body height, each written
+// to both sides like the clip's mirrored tracks
+static void handJump(float t, float* out)
+{
+    const float p = std::fmod(t, 2.2f) / 2.2f;
+    float knee = 0.0f, leg = 0.0f, arm = 0.0f, elbow = 0.0f, torso = 0.0f, bodyY = 0.0f;
+    if (p < 0.18f) {
+        float s = phaseProgress(p, 0.0f, 0.18f);
+        knee = mix(0.0f, glm::radians(75.0f), s);
+        leg = mix(0.0f, glm::radians(-38.0f), s);
+        arm = mix(0.0f, glm::radians(25.0f), s);
+        elbow = mix(0.0f, glm::radians(-70.0f), s);
+        torso = mix(0.0f, glm::radians(18.0f), s);
+        bodyY = mix(0.0f, -0.5f, s);
+    } else if (p < 0.36f) {
+        float s = phaseProgress(p, 0.18f, 0.36f);
+        knee = mix(glm::radians(75.0f), 0.0f, s);
+        leg = mix(glm::radians(-38.0f), glm::radians(-22.0f), s);
+        arm = mix(glm::radians(25.0f), glm::radians(-165.0f), s);
+        elbow = mix(glm::radians(-70.0f), 0.0f, s);
+        torso = mix(glm::radians(18.0f), 0.0f, s);
+        bodyY = mix(-0.5f, 3.6f, s);
+    } else if (p < 0.52f) {
+        float s = phaseProgress(p, 0.36f, 0.52f);
+        knee = mix(0.0f, glm::radians(65.0f), s);
+        leg = mix(glm::radians(-22.0f), glm::radians(-8.0f), s);
+        arm = glm::radians(-165.0f);
+        bodyY = mix(3.6f, 3.1f, s);
+    } else if (p < 0.65f) {
+        float s = phaseProgress(p, 0.52f, 0.65f);
+        knee = mix(glm::radians(65.0f), 0.0f, s);
+        leg = mix(glm::radians(-8.0f), 0.0f, s);
+        arm = mix(glm::radians(-165.0f), glm::radians(-60.0f), s);
+        elbow = mix(0.0f, glm::radians(-35.0f), s);
+        bodyY = mix(3.1f, 0.0f, s);
+    } else if (p < 0.82f) {
+        float s = phaseProgress(p, 0.65f, 0.82f);
+        arm = mix(glm::radians(-60.0f), glm::radians(25.0f), s);
+        elbow = mix(glm::radians(-35.0f), glm::radians(-70.0f), s);
+    } else {
+        float s = phaseProgress(p, 0.82f, 1.0f);
+        arm = mix(glm::radians(25.0f), 0.0f, s);
+        elbow = mix(glm::radians(-70.0f), 0.0f, s);
+    }
+    out[0] = out[1] = arm;
+    out[2] = out[3] = leg;
+    out[4] = out[5] = knee;
+    out[6] = out[7] = elbow;
+    out[8] = torso;
+    out[9] = bodyY;
+}
+
+int main()
+{
+    const Clip& jump = *getStateClip(JUMPING);
+    const int count = 2000000;
+    const float frame = 1.0f / 60.0f;
+    float out[CLIP_MAX_TRACKS * 2] = {};
+
+    ClipCursor cursor;
+    // forward playback: the cursor only moves on
+    const double forward = nsPerCall(count, [&](int i) {
+        sampleClip(jump, i * frame, cursor, out);
+        keep(out[0]);
+    });
+    // every sample a fresh cursor: the search from the first key each time
+    const double seek = nsPerCall(count, [&](int i) {
+        cursor.reset();
+        sampleClip(jump, i * frame, cursor, out);
+        keep(out[0]);
+    });
+    const double hand = nsPerCall(count, [&](int i) {
+        handJump(i * frame, out);
+        keep(out[0]);
+    });
+
+    std::printf("jump sample: clip forward %.1f ns, clip seek %.1f ns, hand-written %.1f ns, "
+                "forward/hand %.2fx\n", forward, seek, hand, forward / hand);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// crowd simulation step (update and evaluate every character, as main does)
+// against the JobPool thread count
+#include "animation.hpp"
+#include "bench.hpp"
+#include "jobs.hpp"
+#include "pool.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    const int crowd = 1024, batch = 32, steps = 200;
+    const float step = 1.0f / 60.0f;
+    const Rig rig(RIG_DEFAULT);
+    BakedPoses baked;
+    baked.bake(60.0f);
+    const Animations states[] = {WAVING, WALKING, JUMPING, T_POSE, NARUTO_RUN, EAGLE_FLIGHT};
+
+    std::vector<int> counts = {1, 2, 4, 8, static_cast<int>(std::thread::hardware_concurrency())};
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    double single = 0.0;
+    for (int threads : counts) {
+        if (threads <= 0)
+            continue;
+        CharacterPool characters(crowd);
+        for (int i = 0; i < crowd; ++i)
+            characters.spawn(glm::translate(glm::mat4(1.0f), glm::vec3(4.0f * (i % 32), 0.0f, 4.0f * (i / 32))),
+                             states[i % 6]);
+        JobPool jobs(threads);
+        auto simulate = [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                Animator& character = characters.getLive(i);
+                character.update(step);
+                character.evaluate(rig, &baked);
+            }
+        };
+        // the first step poses every joint; the timed ones only the moving ones
+        jobs.parallelFor(characters.size(), batch, simulate);
+        const double ms = nsPerCall(steps, [&](int) { jobs.parallelFor(characters.size(), batch, simulate); }) / 1e6;
+        if (single == 0.0)
+            single = ms;
+        for (int i = 0; i < characters.size(); ++i)
+            keep(characters.getLive(i).getJointWorld()[JOINT_COUNT - 1].data[12]);
+        std::printf("crowd step, %d threads: %.3f ms for %d characters, %.0f characters/ms, %.2fx one thread\n",
+                    jobs.threadCount(), ms, crowd, crowd / ms, single / ms);
+    }
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    return 0;
+}
@@ -0,0 +1,33 @@
+// mat4 product throughput, scalar reference against the SIMD kernel
+#include "bench.hpp"
+#include "glm.hpp"
+#include <cstdio>
+#include <vector>
+
+template <typename F>
+static double nsPerMul(const std::vector<glm::mat4>& in, std::vector<glm::mat4>& out, int rounds, F mul)
+{
+    const int n = static_cast<int>(in.size());
+    return nsPerCall(rounds, [&](int r) {
+        for (int i = 0; i < n; ++i)
+            out[i] = mul(out[i], in[(i + r) % n]);
+    }) / n;
+}
+
+int main()
+{
+    const int n = 1024, rounds = 2000;
+    std::vector<glm::mat4> in(n), out(n, glm::mat4(1.0f));
+    for (int i = 0; i < n; ++i) {
+        in[i] = glm::mat4(1.0f);
+        in[i].data[12] = 0.001f * i;
+        in[i].data[1] = 0.0001f * (i % 7);
+    }
+    const double scalar = nsPerMul(in, out, rounds, [](const glm::mat4& a, const glm::mat4& b) { return glm::mul_scalar(a, b); });
+    const double simd = nsPerMul(in, out, rounds, [](const glm::mat4& a, const glm::mat4& b) { return glm::mul_simd(a, b); });
+    for (const glm::mat4& m : out)
+        keep(m.data[0]);
+    std::printf("mat4 multiply (GLM_SIMD_WIDTH %d): scalar %.2f ns, simd %.2f ns, %.2fx\n",
+                GLM_SIMD_WIDTH, scalar, simd, scalar / simd);
+    return 0;
+}
@@ -0,0 +1,62 @@
+// baked tables raw against packed: memory, error, and sampling cost when
+// played forward with a cursor and when every sample seeks
+#include "animation.hpp"
+#include "bench.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static const char* const NAMES[ANIMATION_COUNT] = {
+    "NONE", "WAVING", "WALKING", "JUMPING", "T_POSE", "NARUTO_RUN", "EAGLE_FLIGHT"
+};
+
+int main()
+{
+    BakedPoses raw, packed;
+    raw.bake(60.0f);
+    packed.bake(60.0f);
+    packed.compress(0.002f, 0.002f);
+
+    const int count = 1000000;
+    const float step = 1.0f / 60.0f;
+    size_t rawTotal = 0, packedTotal = 0;
+    for (int s = 0; s < ANIMATION_COUNT; ++s) {
+        const Animations state = Animations(s);
+        if (!raw.isBaked(state))
+            continue;
+        PackedCursor cursor, packedCursor;
+        Pose a, b;
+        float rotError = 0.0f, transError = 0.0f;
+        for (int i = 0; i < 10000; ++i) {
+            raw.sample(state, i * 0.0017f, cursor, a);
+            packed.sample(state, i * 0.0017f, packedCursor, b);
+            for (int j = 0; j < JOINT_COUNT; ++j) {
+                const float d = std::min(1.0f, std::fabs(glm::dot(a.rot[j], b.rot[j])));
+                rotError = std::max(rotError, 2.0f * std::acos(d));
+                transError = std::max(transError, glm::length(a.trans[j] - b.trans[j]));
+            }
+        }
+
+        const double rawNs = nsPerCall(count, [&](int i) {
+            raw.sample(state, i * step, cursor, a);
+            keep(a.rot[3].x);
+        });
+        const double forwardNs = nsPerCall(count, [&](int i) {
+            packed.sample(state, i * step, packedCursor, a);
+            keep(a.rot[3].x);
+        });
+        const double seekNs = nsPerCall(count, [&](int i) {
+            packedCursor.reset();
+            packed.sample(state, i * step, packedCursor, a);
+            keep(a.rot[3].x);
+        });
+        rawTotal += raw.byteSize(state);
+        packedTotal += packed.byteSize(state);
+        std::printf("%-12s %6zu B -> %5zu B (%4.1fx), error %.4f rad %.4f | raw %5.1f ns, packed forward %5.1f ns, "
+                    "packed seek %5.1f ns\n", NAMES[s], raw.byteSize(state), packed.byteSize(state),
+                    double(raw.byteSize(state)) / packed.byteSize(state), rotError, transError, rawNs, forwardNs,
+                    seekNs);
+    }
+    std::printf("all tables %zu B -> %zu B (%.1fx)\n", rawTotal, packedTotal, double(rawTotal) / packedTotal);
+    return 0;
+}
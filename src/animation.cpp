@@ -21,206 +21,19 @@ struct AnimAngles
 };
 
 
-static glm::vec3 getPivotPoint(const body& myBody, int partType, bool proximal)
-{
-    for (const auto& part : myBody.getParts())
-    {
-        if (part.getPartType() != static_cast<BodyPartType>(partType))
-            continue;
-        float px = part.getX();
-        float py = part.getY();
-        glm::vec3 s = part.getScale();
-        float pivotY = proximal ? py + s.y * 0.5f : py - s.y * 0.5f;
-        float pivotX;
-        if (partType == RIGHT_UPPER_ARM || partType == LEFT_UPPER_ARM)
-            pivotX = px - (px > 0.0f ? 1.0f : -1.0f) * s.x * 0.5f;
-        else
-            pivotX = px;
-        return glm::vec3(pivotX, pivotY, 0.0f);
-    }
-    return glm::vec3(0.0f, 0.0f, 0.0f);
-}
-
-
-static AnimAngles anim_eagle_flight(float t)
-{
-    AnimAngles a;
-    const float riseTime = 0.4f;
-
-    float angle;
-    if (t < riseTime) {
-        float s = t / riseTime;
-        angle = glm::radians(90.0f) * s;
-    } else {
-        float flap = std::sin((t - riseTime) * 50.0f);
-        angle = glm::radians(90.0f + 25.0f * flap);
-    }
-
-    a.leftArm     = angle;
-    a.leftArmAxis = glm::vec3(0.0f, 0.0f, 1.0f);
-    a.rightArm      = -angle;
-    a.rightArmAxis  = glm::vec3(0.0f, 0.0f, 1.0f);
-    a.shoulderDrop = (std::min(angle, glm::radians(90.0f)) / glm::radians(90.0f)) * -0.5f;
-
-    if (t >= riseTime) {
-        float lift = (t - riseTime) * 30.0f;
-        a.bodyOffset = glm::vec3(0.0f, lift, 0.0f);
-    }
-
-    return a;
-}
-
-static AnimAngles anim_t_pose(float t)
-{
-    AnimAngles a;
-    const float period = 4.0f;
-    float p = std::fmod(t, period) / period;
-
-    float angle;
-    if (p < 0.1f) {
-        float s = p / 0.1f;
-        angle = glm::radians(90.0f) * s;
-    } else if (p < 0.7f) {
-        angle = glm::radians(90.0f);
-    } else if (p < 0.80f) {
-        float s = (p - 0.7f) / 0.1f;
-        angle = glm::radians(90.0f) * (1.0f - s);
-    } else {
-        angle = 0.0f;
-    }
-
-    a.leftArm     = angle;
-    a.leftArmAxis = glm::vec3(0.0f, 0.0f, 1.0f);
-    a.rightArm      = -angle;
-    a.rightArmAxis  = glm::vec3(0.0f, 0.0f, 1.0f);
-
-    a.shoulderDrop = (angle / glm::radians(90.0f)) * -0.5f;
-    return a;
-}
-
 static AnimAngles anim_waving(float t)
 {
     AnimAngles a;
-    a.leftArm     = glm::radians(160.0f + 20.0f * std::sin(t * 3.0f));
+    a.leftArm     = glm::radians(160.0f + 20.0f * glm::sin(t * 3.0f));
     a.leftArmAxis = glm::vec3(0.0f, 0.0f, 1.0f);
     return a;
 }
 
 
-static float clampUnit(float x)
-{
-    if (x < 0.f)
-        return 0.f;
-    if (x > 1.f)
-        return 1.f;
-    return x;
-}
-
-
-static float easeInOut(float x)
-{
-    return x * x * (3.0f - 2.0f * x);
-}
-
-
-static float linearInterp(float a, float b, float s)
-{
-    return a + (b - a) * s;
-}
-
-
-static float phaseProgress(float p, float start, float end)
-{
-    float t = (p - start) / (end - start);
-    return easeInOut(clampUnit(t));
-}
-
-
-static AnimAngles anim_jumping(float t)
-{
-    AnimAngles a;
-
-    const float period = 2.2f;
-    float p = std::fmod(t, period) / period;
-
-
-    float kneeAngle  = 0.0f;
-    float legAngle   = 0.0f;
-    float armAngle   = 0.0f;
-    float elbowAngle = 0.0f;
-    float torsoAngle = 0.0f;
-    float bodyY      = 0.0f;
-
-    // Part 1 [0-18%]: Squat
-    if (p < 0.18f) {
-        float s = phaseProgress(p, 0.0f, 0.18f);
-        kneeAngle = linearInterp(0.0f, glm::radians(75.0f), s);
-        legAngle = linearInterp(0.0f, glm::radians(-38.0f), s);
-        armAngle = linearInterp(0.0f, glm::radians(25.0f), s);
-        elbowAngle = linearInterp(0.0f, -glm::radians(70.0f), s);
-        torsoAngle = linearInterp(0.0f, glm::radians(18.0f), s);
-        bodyY = linearInterp(0.0f, -0.5f, s);
-    }
-    // Part 2 [18-36%]: Jump
-    else if (p < 0.36f) {
-        float s = phaseProgress(p, 0.18f, 0.36f);
-        kneeAngle = linearInterp(glm::radians(75.0f), 0.0f, s);
-        legAngle = linearInterp(glm::radians(-38.0f), glm::radians(-22.0f), s);
-        armAngle = linearInterp(glm::radians(25.0f), glm::radians(-165.0f), s);
-        elbowAngle = linearInterp(-glm::radians(70.0f), 0.0f, s);
-        torsoAngle = linearInterp(glm::radians(18.0f), 0.0f, s);
-        bodyY = linearInterp(-0.5f, 3.6f, s);
-    }
-    // Part 3 [36-52%]: Apex
-    else if (p < 0.52f) {
-        float s = phaseProgress(p, 0.36f, 0.52f);
-        kneeAngle = linearInterp(0.0f, glm::radians(65.0f), s);
-        legAngle = linearInterp(glm::radians(-22.0f), glm::radians(-8.0f), s);
-        armAngle = glm::radians(-165.0f);
-        bodyY = linearInterp(3.6f, 3.1f, s);
-    }
-    // Part 4 [52-65%]: Descent
-    else if (p < 0.65f) {
-        float s = phaseProgress(p, 0.52f, 0.65f);
-        kneeAngle = linearInterp(glm::radians(65.0f), 0.0f, s);
-        legAngle = linearInterp(glm::radians(-8.0f), 0.0f, s);
-        armAngle = linearInterp(glm::radians(-165.0f), glm::radians(-60.0f), s);
-        elbowAngle = linearInterp(0.0f, -glm::radians(35.0f), s);
-        bodyY = linearInterp(3.1f, 0.0f, s);
-    }
-    // Part 5 [65-100%]: Recover
-    else {
-        if (p < 0.82f) {
-            float s = easeInOut(clampUnit((p - 0.65f) / 0.17f));
-            armAngle = linearInterp(glm::radians(-60.0f), glm::radians(25.0f), s);
-            elbowAngle = linearInterp(-glm::radians(35.0f), -glm::radians(70.0f), s);
-        }
-        else {
-            float s = easeInOut(clampUnit((p - 0.82f) / 0.18f));
-            armAngle = linearInterp(glm::radians(25.0f), 0.0f, s);
-            elbowAngle = linearInterp(-glm::radians(70.0f), 0.0f, s);
-        }
-        bodyY = 0.0f;
-    }
-
-    a.bodyOffset = glm::vec3(0.0f, bodyY, 0.0f);
-    a.rightLeg = legAngle;
-    a.leftLeg = legAngle;
-    a.rightKnee = kneeAngle;
-    a.leftKnee = kneeAngle;
-    a.rightArm = armAngle;
-    a.leftArm = armAngle;
-    a.rightElbow = elbowAngle;
-    a.leftElbow = elbowAngle;
-    a.torsoAngle = torsoAngle;
-    return a;
-}
-
-
 static AnimAngles anim_walking(float t)
 {
     AnimAngles a;
-    float swing = std::sin(t * 4.0f);
+    float swing = glm::sin(t * 4.0f);
     a.rightLeg = glm::radians(35.0f * swing);
     a.leftLeg = -glm::radians(35.0f * swing);
     a.rightArm = -glm::radians(15.0f * swing);
@@ -236,8 +49,8 @@ static AnimAngles anim_walking(float t)
 static AnimAngles anim_naruto_run(float t)
 {
     AnimAngles a;
-    float armSwing = std::sin(t * 5.0f);
-    float legSwing = std::sin(t * 12.0f);
+    float armSwing = glm::sin(t * 5.0f);
+    float legSwing = glm::sin(t * 12.0f);
 
     a.torsoAngle = glm::radians(45.0f);
     a.leftArm = glm::radians(55.0f + 8.0f * armSwing);
@@ -250,7 +63,203 @@ static AnimAngles anim_naruto_run(float t)
     return a;
 }
 
-static AnimAngles getAnimAngles(int state, float t)
+// ---- keyframed clips ----
+// Phase-based clips are plain data on the clip engine (clip.hpp); each
+// track drives one AnimAngles channel.
+
+enum AnimChannel
+{
+    CH_LEFT_ARM,
+    CH_RIGHT_ARM,
+    CH_LEFT_LEG,
+    CH_RIGHT_LEG,
+    CH_LEFT_KNEE,
+    CH_RIGHT_KNEE,
+    CH_LEFT_ELBOW,
+    CH_RIGHT_ELBOW,
+    CH_TORSO,
+    CH_SHOULDER_DROP,
+    CH_BODY_Y,
+    CHANNEL_COUNT
+};
+
+struct KeyedClip
+{
+    Clip clip;
+    glm::vec3 leftArmAxis;
+    glm::vec3 rightArmAxis;
+};
+
+static AnimAngles sampleKeyedClip(const KeyedClip& k, float t, ClipCursor& cursor)
+{
+    float ch[CHANNEL_COUNT] = {};
+    sampleClip(k.clip, t, cursor, ch);
+
+    AnimAngles a;
+    a.leftArm = ch[CH_LEFT_ARM];
+    a.rightArm = ch[CH_RIGHT_ARM];
+    a.leftLeg = ch[CH_LEFT_LEG];
+    a.rightLeg = ch[CH_RIGHT_LEG];
+    a.leftKnee = ch[CH_LEFT_KNEE];
+    a.rightKnee = ch[CH_RIGHT_KNEE];
+    a.leftElbow = ch[CH_LEFT_ELBOW];
+    a.rightElbow = ch[CH_RIGHT_ELBOW];
+    a.torsoAngle = ch[CH_TORSO];
+    a.shoulderDrop = ch[CH_SHOULDER_DROP];
+    a.bodyOffset = glm::vec3(0.0f, ch[CH_BODY_Y], 0.0f);
+    a.leftArmAxis = k.leftArmAxis;
+    a.rightArmAxis = k.rightArmAxis;
+    return a;
+}
+
+#define TRACK_COUNT(tracks) static_cast<int>(sizeof(tracks) / sizeof(tracks[0]))
+#define KEY_TRACK(channel, keys) {channel, -1, 0.0f, keys, TRACK_COUNT(keys), false}
+#define MIRROR_TRACK(channel, mirror, scale, keys) {channel, mirror, scale, keys, TRACK_COUNT(keys), false}
+
+
+// T_POSE: arms rise to horizontal, hold, drop, rest; 4 s loop
+static const Keyframe TPOSE_ARM[] = {
+    {0.0f, 0.0f, INTERP_LINEAR},
+    {0.4f, glm::radians(90.0f), INTERP_LINEAR},
+    {2.8f, glm::radians(90.0f), INTERP_LINEAR},
+    {3.2f, 0.0f, INTERP_LINEAR},
+};
+static const Keyframe TPOSE_SHOULDER[] = {
+    {0.0f, 0.0f, INTERP_LINEAR},
+    {0.4f, -0.5f, INTERP_LINEAR},
+    {2.8f, -0.5f, INTERP_LINEAR},
+    {3.2f, 0.0f, INTERP_LINEAR},
+};
+static const ClipTrack TPOSE_TRACKS[] = {
+    MIRROR_TRACK(CH_LEFT_ARM, CH_RIGHT_ARM, -1.0f, TPOSE_ARM),
+    KEY_TRACK(CH_SHOULDER_DROP, TPOSE_SHOULDER),
+};
+static const KeyedClip TPOSE_CLIP = {
+    {TPOSE_TRACKS, TRACK_COUNT(TPOSE_TRACKS), 4.0f, true, 0.0f},
+    glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f)
+};
+
+
+// EAGLE_FLIGHT: arms rise in 0.4 s, then flap as 90 +/- 25 degrees at
+// 50 rad/s (Hermite keys on the quarter periods) while the body lifts at
+// 30 units/s forever
+constexpr float EAGLE_RISE = 0.4f;
+constexpr float EAGLE_FLAP = 2.0f * PI / 50.0f;
+constexpr float EAGLE_ARM_SLOPE = glm::radians(25.0f) * 50.0f;
+// shoulders follow min(angle, 90) / 90 * -0.5, so only the lower half of a flap moves them
+constexpr float EAGLE_SHOULDER_SLOPE = 0.5f * 25.0f * 50.0f / 90.0f;
+
+static const Keyframe EAGLE_ARM[] = {
+    {0.0f, 0.0f, INTERP_LINEAR},
+    {EAGLE_RISE, glm::radians(90.0f), INTERP_HERMITE, EAGLE_ARM_SLOPE},
+    {EAGLE_RISE + EAGLE_FLAP * 0.25f, glm::radians(115.0f), INTERP_HERMITE, 0.0f},
+    {EAGLE_RISE + EAGLE_FLAP * 0.5f, glm::radians(90.0f), INTERP_HERMITE, -EAGLE_ARM_SLOPE},
+    {EAGLE_RISE + EAGLE_FLAP * 0.75f, glm::radians(65.0f), INTERP_HERMITE, 0.0f},
+    {EAGLE_RISE + EAGLE_FLAP, glm::radians(90.0f), INTERP_HERMITE, EAGLE_ARM_SLOPE},
+};
+static const Keyframe EAGLE_SHOULDER[] = {
+    {0.0f, 0.0f, INTERP_LINEAR},
+    {EAGLE_RISE, -0.5f, INTERP_LINEAR},
+    {EAGLE_RISE + EAGLE_FLAP * 0.5f, -0.5f, INTERP_HERMITE, EAGLE_SHOULDER_SLOPE},
+    {EAGLE_RISE + EAGLE_FLAP * 0.75f, -0.5f * 65.0f / 90.0f, INTERP_HERMITE, 0.0f},
+    {EAGLE_RISE + EAGLE_FLAP, -0.5f, INTERP_HERMITE, -EAGLE_SHOULDER_SLOPE},
+};
+static const Keyframe EAGLE_LIFT[] = {
+    {0.0f, 0.0f, INTERP_STEP},
+    {EAGLE_RISE, 0.0f, INTERP_LINEAR},
+    {EAGLE_RISE + 1.0f, 30.0f, INTERP_LINEAR},
+};
+static const ClipTrack EAGLE_TRACKS[] = {
+    MIRROR_TRACK(CH_LEFT_ARM, CH_RIGHT_ARM, -1.0f, EAGLE_ARM),
+    KEY_TRACK(CH_SHOULDER_DROP, EAGLE_SHOULDER),
+    {CH_BODY_Y, -1, 0.0f, EAGLE_LIFT, TRACK_COUNT(EAGLE_LIFT), true},
+};
+static const KeyedClip EAGLE_CLIP = {
+    // loops the flap only, the rise plays once
+    {EAGLE_TRACKS, TRACK_COUNT(EAGLE_TRACKS), EAGLE_RISE + EAGLE_FLAP, true, EAGLE_RISE},
+    glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f)
+};
+
+
+// JUMPING: squat, jump, apex, descent, recover; 2.2 s loop, each phase
+// eased with smoothstep. Key times are the phase boundaries.
+constexpr float JUMP_PERIOD = 2.2f;
+
+static const Keyframe JUMP_KNEE[] = {
+    {0.00f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.18f * JUMP_PERIOD, glm::radians(75.0f), INTERP_SMOOTH},
+    {0.36f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.52f * JUMP_PERIOD, glm::radians(65.0f), INTERP_SMOOTH},
+    {0.65f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+};
+static const Keyframe JUMP_LEG[] = {
+    {0.00f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.18f * JUMP_PERIOD, glm::radians(-38.0f), INTERP_SMOOTH},
+    {0.36f * JUMP_PERIOD, glm::radians(-22.0f), INTERP_SMOOTH},
+    {0.52f * JUMP_PERIOD, glm::radians(-8.0f), INTERP_SMOOTH},
+    {0.65f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+};
+static const Keyframe JUMP_ARM[] = {
+    {0.00f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.18f * JUMP_PERIOD, glm::radians(25.0f), INTERP_SMOOTH},
+    {0.36f * JUMP_PERIOD, glm::radians(-165.0f), INTERP_STEP},
+    {0.52f * JUMP_PERIOD, glm::radians(-165.0f), INTERP_SMOOTH},
+    {0.65f * JUMP_PERIOD, glm::radians(-60.0f), INTERP_SMOOTH},
+    {0.82f * JUMP_PERIOD, glm::radians(25.0f), INTERP_SMOOTH},
+    {1.00f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+};
+static const Keyframe JUMP_ELBOW[] = {
+    {0.00f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.18f * JUMP_PERIOD, glm::radians(-70.0f), INTERP_SMOOTH},
+    {0.36f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+    {0.52f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.65f * JUMP_PERIOD, glm::radians(-35.0f), INTERP_SMOOTH},
+    {0.82f * JUMP_PERIOD, glm::radians(-70.0f), INTERP_SMOOTH},
+    {1.00f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+};
+static const Keyframe JUMP_TORSO[] = {
+    {0.00f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.18f * JUMP_PERIOD, glm::radians(18.0f), INTERP_SMOOTH},
+    {0.36f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+};
+static const Keyframe JUMP_BODY_Y[] = {
+    {0.00f * JUMP_PERIOD, 0.0f, INTERP_SMOOTH},
+    {0.18f * JUMP_PERIOD, -0.5f, INTERP_SMOOTH},
+    {0.36f * JUMP_PERIOD, 3.6f, INTERP_SMOOTH},
+    {0.52f * JUMP_PERIOD, 3.1f, INTERP_SMOOTH},
+    {0.65f * JUMP_PERIOD, 0.0f, INTERP_STEP},
+};
+static const ClipTrack JUMP_TRACKS[] = {
+    MIRROR_TRACK(CH_LEFT_KNEE, CH_RIGHT_KNEE, 1.0f, JUMP_KNEE),
+    MIRROR_TRACK(CH_LEFT_LEG, CH_RIGHT_LEG, 1.0f, JUMP_LEG),
+    MIRROR_TRACK(CH_LEFT_ARM, CH_RIGHT_ARM, 1.0f, JUMP_ARM),
+    MIRROR_TRACK(CH_LEFT_ELBOW, CH_RIGHT_ELBOW, 1.0f, JUMP_ELBOW),
+    KEY_TRACK(CH_TORSO, JUMP_TORSO),
+    KEY_TRACK(CH_BODY_Y, JUMP_BODY_Y),
+};
+static const KeyedClip JUMP_CLIP = {
+    {JUMP_TRACKS, TRACK_COUNT(JUMP_TRACKS), JUMP_PERIOD, true, 0.0f},
+    glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f)
+};
+
+
+const Clip* getStateClip(Animations state)
+{
+    switch (state)
+    {
+        case JUMPING:
+            return &JUMP_CLIP.clip;
+        case T_POSE:
+            return &TPOSE_CLIP.clip;
+        case EAGLE_FLIGHT:
+            return &EAGLE_CLIP.clip;
+        default:
+            return nullptr;
+    }
+}
+
+
+static AnimAngles getAnimAngles(int state, float t, ClipCursor& cursor)
 {
     switch (state)
     {
@@ -259,77 +268,200 @@ static AnimAngles getAnimAngles(int state, float t)
         case WALKING:
             return anim_walking(t);
         case JUMPING:
-            return anim_jumping(t);
+            return sampleKeyedClip(JUMP_CLIP, t, cursor);
         case T_POSE:
-            return anim_t_pose(t);
+            return sampleKeyedClip(TPOSE_CLIP, t, cursor);
         case NARUTO_RUN:
             return anim_naruto_run(t);
         case EAGLE_FLIGHT:
-            return anim_eagle_flight(t);
+            return sampleKeyedClip(EAGLE_CLIP, t, cursor);
         default:
             return AnimAngles();
     }
 }
 
-static void applyKneeRotation(glm::mat4& model, const glm::vec3& hip, float hipAngle, const glm::vec3& knee, float kneeAngle, const glm::vec3& partPos)
+// rotation from the sine/cosine of half the angle about a unit axis
+static glm::quat halfAngleQuat(float s, float c, const glm::vec3& axis)
 {
-    const glm::vec3 axis(1.0f, 0.0f, 0.0f);
-    model = glm::translate(model, hip);
-    model = glm::rotate(model, hipAngle, axis);
-    model = glm::translate(model, knee - hip);
-    model = glm::rotate(model, kneeAngle, axis);
-    model = glm::translate(model, glm::vec3(-knee.x, -knee.y, -knee.z));
-    model = glm::translate(model, partPos);
+    return glm::quat(c, axis.x * s, axis.y * s, axis.z * s);
 }
 
-static void applyPivotRotation(glm::mat4& model, const glm::vec3& pivot, float angle, const glm::vec3& axis, const glm::vec3& partPos)
+// which AnimAngles channels pose each joint, one row per RigJoint
+struct JointChannels
 {
-    glm::vec3 neg(-pivot.x, -pivot.y, -pivot.z);
-    model = glm::translate(model, pivot);
-    model = glm::rotate(model, angle, axis);
-    model = glm::translate(model, neg);
-    model = glm::translate(model, partPos);
+    float AnimAngles::*angle;        // rotation angle, nullptr for none
+    glm::vec3 AnimAngles::*axis;     // rotation axis, nullptr for x
+    glm::vec3 AnimAngles::*offset;   // translation, nullptr for none
+    float AnimAngles::*drop;         // added to the translation's y, nullptr for none
+};
+
+static const JointChannels JOINT_CHANNELS[] = {
+    {nullptr, nullptr, &AnimAngles::bodyOffset, nullptr},                       // JOINT_ROOT
+    {&AnimAngles::torsoAngle, nullptr, nullptr, nullptr},                       // JOINT_SPINE
+    // the shoulders drop with the whole arm chain below them
+    {&AnimAngles::rightArm, &AnimAngles::rightArmAxis, nullptr, &AnimAngles::shoulderDrop},
+    {&AnimAngles::rightElbow, nullptr, nullptr, nullptr},
+    {&AnimAngles::leftArm, &AnimAngles::leftArmAxis, nullptr, &AnimAngles::shoulderDrop},
+    {&AnimAngles::leftElbow, nullptr, nullptr, nullptr},
+    {&AnimAngles::rightLeg, nullptr, nullptr, nullptr},
+    {&AnimAngles::rightKnee, nullptr, nullptr, nullptr},
+    {&AnimAngles::leftLeg, nullptr, nullptr, nullptr},
+    {&AnimAngles::leftKnee, nullptr, nullptr, nullptr},
+};
+static_assert(sizeof(JOINT_CHANNELS) / sizeof(JOINT_CHANNELS[0]) == JOINT_COUNT,
+              "every RigJoint needs a row in JOINT_CHANNELS");
+
+// writes the joints in mask only, so a layer over one arm costs two joints
+static void getPose(const AnimAngles& a, Pose& pose, JointMask mask = MASK_ALL)
+{
+    const glm::vec3 xAxis(1.0f, 0.0f, 0.0f);
+    // the half angles of the masked joints go through one batched sincos
+    int joint[JOINT_COUNT];
+    float half[JOINT_COUNT];
+    int n = 0;
+    for (int j = 0; j < JOINT_COUNT; ++j)
+        if (mask & jointBit(j)) {
+            joint[n] = j;
+            half[n++] = JOINT_CHANNELS[j].angle ? a.*JOINT_CHANNELS[j].angle * 0.5f : 0.0f;
+        }
+    float s[JOINT_COUNT], c[JOINT_COUNT];
+    glm::sincosBatch(half, s, c, n);
+
+    for (int i = 0; i < n; ++i) {
+        const int j = joint[i];
+        const JointChannels& ch = JOINT_CHANNELS[j];
+        const glm::vec3 axis = ch.axis ? glm::normalize(a.*ch.axis) : xAxis;
+        glm::vec3 trans = ch.offset ? a.*ch.offset : glm::vec3(0.0f, 0.0f, 0.0f);
+        if (ch.drop)
+            trans.y += a.*ch.drop;
+        pose.rot[j] = halfAngleQuat(s[i], c[i], axis);
+        pose.trans[j] = trans;
+    }
 }
 
-static void applyTorsoArmRotation(glm::mat4& model, const glm::vec3& torsoBase, float torsoAngle, const glm::vec3& shoulder, float armAngle, const glm::vec3& armAxis, const glm::vec3& partPos)
+// loop length of each clip that repeats exactly, 0 for the others (NONE is a
+// still pose, eagle flight climbs forever, the rest have no clip)
+static float loopPeriod(int state)
 {
-    model = glm::translate(model, torsoBase);
-    model = glm::rotate(model, torsoAngle, glm::vec3(1.0f, 0.0f, 0.0f));
-    model = glm::translate(model, glm::vec3(-torsoBase.x, -torsoBase.y, -torsoBase.z));
+    switch (state)
+    {
+        case WAVING:
+            return 2.0f * PI / 3.0f;
+        case WALKING:
+            return 2.0f * PI / 4.0f;
+        case JUMPING:
+            return JUMP_PERIOD;
+        case T_POSE:
+            return TPOSE_CLIP.clip.duration;
+        case NARUTO_RUN:
+            // arms at 5 rad/s, legs at 12 rad/s: both line up after 2 pi
+            return 2.0f * PI;
+        default:
+            return 0.0f;
+    }
+}
 
-    model = glm::translate(model, shoulder);
-    model = glm::rotate(model, armAngle, armAxis);
-    model = glm::translate(model, glm::vec3(-shoulder.x, -shoulder.y, -shoulder.z));
 
-    model = glm::translate(model, partPos);
+void BakedPoses::bake(float rate)
+{
+    for (int state = 0; state < ANIMATION_COUNT; ++state) {
+        Table& table = _tables[state];
+        table = Table();
+        const float period = loopPeriod(state);
+        if (period <= 0.0f || rate <= 0.0f)
+            continue;
+        table.period = period;
+        table.frameCount = std::max(1, static_cast<int>(std::ceil(period * rate)));
+        table.rate = table.frameCount / period;
+        table.frames.resize(table.frameCount + 1);
+
+        // sampled in order, so keyframed clips walk their cursor forward
+        ClipCursor cursor;
+        for (int f = 0; f < table.frameCount; ++f)
+            getPose(getAnimAngles(state, f / table.rate, cursor), table.frames[f]);
+        table.frames[table.frameCount] = table.frames[0];
+    }
 }
 
-static void applyTorsoElbowRotation(glm::mat4& model, const glm::vec3& torsoBase, float torsoAngle, const glm::vec3& shoulder, float shoulderAngle, const glm::vec3& shoulderAxis, const glm::vec3& elbow, float elbowAngle, const glm::vec3& partPos)
+
+void BakedPoses::compress(float rotError, float transError)
 {
-    const glm::vec3 elbowAxis(1.0f, 0.0f, 0.0f);
+    for (Table& table : _tables) {
+        if (table.frames.empty())
+            continue;
+        table.packed.pack(table.frames.data(), table.frameCount, rotError, transError);
+        std::vector<Pose>().swap(table.frames);
+    }
+}
 
-    model = glm::translate(model, torsoBase);
-    model = glm::rotate(model, torsoAngle, glm::vec3(1.0f, 0.0f, 0.0f));
-    model = glm::translate(model, glm::vec3(-torsoBase.x, -torsoBase.y, -torsoBase.z));
 
-    model = glm::translate(model, shoulder);
-    model = glm::rotate(model, shoulderAngle, shoulderAxis);
+size_t BakedPoses::byteSize(Animations state) const
+{
+    const Table& table = _tables[state];
+    if (table.frames.empty())
+        return table.packed.isPacked() ? table.packed.byteSize() : 0;
+    return table.frames.capacity() * sizeof(Pose);
+}
 
-    model = glm::translate(model, elbow - shoulder);
-    model = glm::rotate(model, elbowAngle, elbowAxis);
-    model = glm::translate(model, glm::vec3(-elbow.x, -elbow.y, -elbow.z));
 
-    model = glm::translate(model, partPos);
+void BakedPoses::sample(Animations state, float t, PackedCursor& cursor, Pose& pose, JointMask mask) const
+{
+    const Table& table = _tables[state];
+    float u = std::fmod(t, table.period) * table.rate;
+    int f = static_cast<int>(u);
+    if (f >= table.frameCount)
+        f = table.frameCount - 1;
+    if (table.frames.empty()) {
+        table.packed.sample(u, cursor, pose, mask);
+        return;
+    }
+    if (mask == MASK_ALL) {
+        lerpPose(table.frames[f], table.frames[f + 1], u - f, pose);
+        return;
+    }
+    const Pose& a = table.frames[f];
+    const Pose& b = table.frames[f + 1];
+    for (int j = 0; j < JOINT_COUNT; ++j)
+        if (mask & jointBit(j)) {
+            pose.rot[j] = glm::nlerp(a.rot[j], b.rot[j], u - f);
+            pose.trans[j] = glm::lerp(a.trans[j], b.trans[j], u - f);
+        }
 }
 
 
-Animator::Animator() : _state(NONE), _time(0.0f) {}
+Animator::Animator() : _state(NONE), _time(0.0f), _fromState(NONE), _fromTime(0.0f), _fromFrozen(false),
+    _fadeSampled(false), _fadeTime(0.0f), _fadeLength(0.0f), _crossFade(0.25f), _root(1.0f), _poseValid(false), _posedRig(nullptr),
+    _jointsUpdated(0), _interpolated(false) {}
 
 
 void Animator::setState(Animations state)
 {
+    setState(state, _crossFade);
+}
+
+
+void Animator::setState(Animations state, float fadeSeconds)
+{
+    // the clip playing now becomes the outgoing one. A fade cut off midway
+    // fades out of the blend it last showed, frozen, so the pose does not
+    // jump; one cut off before it was ever evaluated keeps its own source
+    if (fadeSeconds > 0.0f) {
+        if (!isFading()) {
+            _fromState = _state;
+            _fromTime = _time;
+            _fromCursor = _cursor;
+            _fromFrozen = false;
+        } else if (_fadeSampled) {
+            _fromPose = _fadePose;
+            _fromFrozen = true;
+        }
+        _fadeTime = 0.0f;
+    }
+    _fadeLength = fadeSeconds > 0.0f ? fadeSeconds : 0.0f;
+    _fadeSampled = false;
     _state = state;
     _time  = 0.0f;
+    _cursor.reset();
 }
 
 
@@ -337,128 +469,258 @@ void Animator::update(float deltaTime)
 {
     if (_state != NONE)
         _time += deltaTime;
+    if (_fadeLength > 0.0f) {
+        if (_fromState != NONE && !_fromFrozen)
+            _fromTime += deltaTime;
+        _fadeTime += deltaTime;
+        if (_fadeTime >= _fadeLength)
+            _fadeLength = 0.0f;
+    }
+    for (Layer& layer : _layers)
+        if (layer.mask && layer.state != NONE)
+            layer.time += deltaTime;
 }
 
 
-void Animator::draw(Shader& ourShader, body& myBody)
+int Animator::addLayer(Animations state, JointMask mask, LayerMode mode, float weight)
 {
-    const AnimAngles a = getAnimAngles(_state, _time);
-    const glm::vec3 torsoBase = getPivotPoint(myBody, TORSO, false) + a.bodyOffset;
+    mask &= MASK_ALL;
+    if (!mask)
+        return -1;
+    for (int i = 0; i < ANIM_MAX_LAYERS; ++i)
+        if (!_layers[i].mask) {
+            Layer& layer = _layers[i];
+            layer = Layer();
+            layer.state = state;
+            layer.mask = mask;
+            layer.mode = mode;
+            layer.weight = weight;
+            return i;
+        }
+    return -1;
+}
 
-    const glm::vec3 shoulderOff = glm::vec3(0.0f, a.shoulderDrop, 0.0f);
-    const glm::vec3 rightShoulder = getPivotPoint(myBody, RIGHT_UPPER_ARM, true) + a.bodyOffset + shoulderOff;
-    const glm::vec3 leftShoulder = getPivotPoint(myBody, LEFT_UPPER_ARM, true) + a.bodyOffset + shoulderOff;
-    const glm::vec3 rightElbow = getPivotPoint(myBody, RIGHT_UPPER_ARM, false) + a.bodyOffset + shoulderOff;
-    const glm::vec3 leftElbow = getPivotPoint(myBody, LEFT_UPPER_ARM, false) + a.bodyOffset + shoulderOff;
-    const glm::vec3 rightHip = getPivotPoint(myBody, RIGHT_THIGH, true) + a.bodyOffset;
-    const glm::vec3 leftHip = getPivotPoint(myBody, LEFT_THIGH, true) + a.bodyOffset;
-    const glm::vec3 rightKnee = getPivotPoint(myBody, RIGHT_THIGH, false) + a.bodyOffset;
-    const glm::vec3 leftKnee = getPivotPoint(myBody, LEFT_THIGH, false) + a.bodyOffset;
 
-    if (_state == NONE) {
-        myBody.draw_head(ourShader);
-        myBody.draw_body(ourShader);
-        myBody.draw_arm(ourShader);
-        myBody.draw_leg(ourShader);
-        myBody.draw_cap(ourShader);
-        return;
-    }
-    
-    ourShader.setBool("useOverrideColor", true);
+void Animator::setRoot(const glm::mat4& root)
+{
+    _root = root;
+    // the root joint and everything below it move with the new root
+    _poseValid = false;
+}
 
-    // ---- CAP / VISIERE ----
-    for (const auto& part : myBody.getParts()) {
-        BodyPartType type = part.getPartType();
-        if (type != CAP && type != VISIERE) continue;
-        glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-        glm::mat4 model(1.0f);
-        applyPivotRotation(model, torsoBase, a.torsoAngle, glm::vec3(1,0,0), pos + a.bodyOffset);
-        model = glm::scale(model, part.getScale());
-        if (type == CAP)
-            ourShader.setVec3("overrideColor", 0.0f, 0.0f, 0.0f);
-        else
-            ourShader.setVec3("overrideColor", 1.0f, 0.0f, 0.0f);
-        ourShader.setMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-    }
 
-    // ---- HEAD ----
-    ourShader.setVec3("overrideColor", 1.0f, 187.0f/255.0f, 119.0f/255.0f);
-    for (const auto& part : myBody.getParts()) {
-        if (part.getPartType() != HEAD) continue;
-        glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-        glm::mat4 model(1.0f);
-        applyPivotRotation(model, torsoBase, a.torsoAngle, glm::vec3(1,0,0), pos + a.bodyOffset);
-        model = glm::scale(model, part.getScale());
-        ourShader.setMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-    }
+static bool sameJointPose(const Pose& a, const Pose& b, int j)
+{
+    const glm::quat& p = a.rot[j];
+    const glm::quat& q = b.rot[j];
+    return p.w == q.w && p.x == q.x && p.y == q.y && p.z == q.z && a.trans[j] == b.trans[j];
+}
 
-    // ---- TORSO ----
-    ourShader.setVec3("overrideColor", 0.0f, 238.0f/255.0f, 221.0f/255.0f);
-    for (const auto& part : myBody.getParts()) {
-        if (part.getPartType() != TORSO) continue;
-        glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-        glm::mat4 model(1.0f);
-        applyPivotRotation(model, torsoBase, a.torsoAngle, glm::vec3(1,0,0), pos + a.bodyOffset);
-        model = glm::scale(model, part.getScale());
-        ourShader.setMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+// one linear pass over the joints in rig order: a joint is dirty when
+// its local pose changed or its parent is dirty, and only dirty joints get a
+// new world matrix (their parent's, already up to date, times local T * R)
+int Animator::updateJoints(const Rig& rig, const Pose& pose)
+{
+    int updated = 0;
+    for (int j = 0; j < JOINT_COUNT; ++j) {
+        const int parent = rig.getJoint(j).parent;
+        _jointDirty[j] = !_poseValid || (parent >= 0 && _jointDirty[parent]) || !sameJointPose(pose, _pose, j);
+        if (!_jointDirty[j])
+            continue;
+        _pose.rot[j] = pose.rot[j];
+        _pose.trans[j] = pose.trans[j];
+        glm::mat4 m = parent < 0 ? _root : _world[parent];
+        glm::postTranslate(m, rigJointOffset(rig.getDef(), j) + _pose.trans[j]);
+        glm::postRotate(m, _pose.rot[j]);
+        _world[j] = m;
+        ++updated;
     }
+    _poseValid = true;
+    return updated;
+}
 
-    // ---- ARMS ----
-    ourShader.setVec3("overrideColor", 1.0f, 187.0f/255.0f, 119.0f/255.0f);
-    for (const auto& part : myBody.getParts()) {
-        BodyPartType type = part.getPartType();
-        if (type != RIGHT_UPPER_ARM && type != RIGHT_LOWER_ARM && type != LEFT_UPPER_ARM && type != LEFT_LOWER_ARM)
+
+static void samplePose(int state, float t, PlayCursor& cursor, const BakedPoses* baked, Pose& pose,
+                       JointMask mask = MASK_ALL)
+{
+    if (baked && baked->isBaked(Animations(state)))
+        baked->sample(Animations(state), t, cursor.packed, pose, mask);
+    else
+        getPose(getAnimAngles(state, t, cursor.clip), pose, mask);
+}
+
+// combines layer into pose on the joints of mask only
+static void applyLayer(const Pose& layer, JointMask mask, LayerMode mode, float weight, Pose& pose)
+{
+    const glm::quat identity;
+    for (int j = 0; j < JOINT_COUNT; ++j) {
+        if (!(mask & jointBit(j)))
             continue;
-        glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-        pos = pos + a.bodyOffset + shoulderOff;
-        glm::mat4 model(1.0f);
-        bool isLeftArm = (part.getX() > 0.0f);
-        bool isLower = (type == RIGHT_LOWER_ARM || type == LEFT_LOWER_ARM);
-        if (isLeftArm) {
-            if (isLower && a.leftElbow != 0.0f)
-                applyTorsoElbowRotation(model, torsoBase, a.torsoAngle, leftShoulder, a.leftArm, a.leftArmAxis,
-                                        leftElbow, a.leftElbow, pos);
-            else
-                applyTorsoArmRotation(model, torsoBase, a.torsoAngle, leftShoulder, a.leftArm, a.leftArmAxis, pos);
+        if (mode == LAYER_ADDITIVE) {
+            pose.rot[j] = pose.rot[j] * glm::nlerp(identity, layer.rot[j], weight);
+            pose.trans[j] += layer.trans[j] * weight;
         } else {
-            if (isLower && a.rightElbow != 0.0f)
-                applyTorsoElbowRotation(model, torsoBase, a.torsoAngle, rightShoulder, a.rightArm, a.rightArmAxis,
-                                        rightElbow, a.rightElbow, pos);
-            else
-                applyTorsoArmRotation(model, torsoBase, a.torsoAngle, rightShoulder, a.rightArm, a.rightArmAxis, pos);
+            pose.rot[j] = glm::nlerp(pose.rot[j], layer.rot[j], weight);
+            pose.trans[j] = glm::lerp(pose.trans[j], layer.trans[j], weight);
         }
-        model = glm::scale(model, part.getScale());
-        ourShader.setMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
     }
+}
 
-    // ---- LEGS ----
-    ourShader.setVec3("overrideColor", 0.0f, 136.0f/255.0f, 204.0f/255.0f);
-    for (const auto& part : myBody.getParts()) {
-        BodyPartType type = part.getPartType();
-        if (type != RIGHT_THIGH && type != RIGHT_LOWER_LEG && type != LEFT_THIGH && type != LEFT_LOWER_LEG)
+
+void Animator::evaluate(const Rig& rig, const BakedPoses* baked)
+{
+    // cached world matrices were built from another rig's joints
+    if (_posedRig != &rig) {
+        _posedRig = &rig;
+        _poseValid = false;
+    }
+    Pose pose;
+    samplePose(_state, _time, _cursor, baked, pose);
+    if (_fadeLength > 0.0f) {
+        // both clips play, their local poses are mixed joint by joint
+        Pose from;
+        if (!_fromFrozen)
+            samplePose(_fromState, _fromTime, _fromCursor, baked, from);
+        float w = _fadeTime / _fadeLength;
+        lerpPose(_fromFrozen ? _fromPose : from, pose, easeInOut(w), pose);
+        _fadePose = pose;
+        _fadeSampled = true;
+    }
+    for (Layer& layer : _layers) {
+        if (!layer.mask || layer.weight <= 0.0f)
+            continue;
+        Pose layerPose;
+        samplePose(layer.state, layer.time, layer.cursor, baked, layerPose, layer.mask);
+        applyLayer(layerPose, layer.mask, layer.mode, layer.weight, pose);
+    }
+    _prevPose = _poseValid ? _pose : pose;
+    _interpolated = false;
+    _jointsUpdated = updateJoints(rig, pose);
+}
+
+
+void Animator::interpolate(const Rig& rig, float alpha)
+{
+    if (!isPosed())
+        return;
+    Pose pose;
+    lerpPose(_prevPose, _pose, alpha, pose);
+    // joints that held still over the step, under parents that did too,
+    // are where the last evaluate() left them
+    bool moved[JOINT_COUNT];
+    for (int j = 0; j < JOINT_COUNT; ++j) {
+        const int parent = rig.getJoint(j).parent;
+        moved[j] = !_poseValid || (parent >= 0 && moved[parent]) || !sameJointPose(_prevPose, _pose, j);
+        if (!moved[j]) {
+            _drawWorld[j] = _world[j];
             continue;
-        glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-        glm::mat4 model(1.0f);
-        bool isRight = (pos.x < 0.0f);
-        if (type == RIGHT_THIGH || type == LEFT_THIGH) {
-            if (isRight)
-                applyPivotRotation(model, rightHip,  a.rightLeg,  glm::vec3(1,0,0), pos + a.bodyOffset);
-            else
-                applyPivotRotation(model, leftHip, a.leftLeg, glm::vec3(1,0,0), pos + a.bodyOffset);
-        } else {
-            if (isRight)
-                applyKneeRotation(model, rightHip,  a.rightLeg,  rightKnee,  a.rightKnee,  pos + a.bodyOffset);
-            else
-                applyKneeRotation(model, leftHip, a.leftLeg, leftKnee, a.leftKnee, pos + a.bodyOffset);
         }
-        model = glm::scale(model, part.getScale());
-        ourShader.setMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glm::mat4 m = parent < 0 ? _root : _drawWorld[parent];
+        glm::postTranslate(m, rigJointOffset(rig.getDef(), j) + pose.trans[j]);
+        glm::postRotate(m, pose.rot[j]);
+        _drawWorld[j] = m;
     }
+    _interpolated = true;
+}
+
+
+RigRenderer::RigRenderer() : _instances(0), _cull(false) {}
+
+
+void RigRenderer::setViewProjection(const glm::mat4& viewProjection)
+{
+    _frustum = glm::extractFrustum(viewProjection);
+    _cull = true;
+}
+
+
+// draw groups, in the order the parts are added to the body
+static const BodyPartType CAP_TYPES[] = {CAP, VISIERE};
+static const BodyPartType HEAD_TYPES[] = {HEAD};
+static const BodyPartType TORSO_TYPES[] = {TORSO};
+static const BodyPartType ARM_TYPES[] = {RIGHT_UPPER_ARM, RIGHT_LOWER_ARM, LEFT_UPPER_ARM, LEFT_LOWER_ARM};
+static const BodyPartType LEG_TYPES[] = {RIGHT_THIGH, RIGHT_LOWER_LEG, LEFT_THIGH, LEFT_LOWER_LEG};
+
+// submits the posed, visible parts of the given types for every instance,
+// found through the body's type table
+void RigRenderer::drawParts(Shader& ourShader, const body& myBody, const BodyPartType* types, int n) const
+{
+    for (int t = 0; t < n; ++t) {
+        int part = myBody.getPartIndex(types[t]);
+        if (part < 0) continue;
+        const int first = part * _instances;
+        for (int i = first; i < first + _instances; ++i) {
+            if (!_visible[i]) continue;
+            ourShader.setMat4("model", _models[i]);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+    }
+}
+
+static void setColor(Shader& ourShader, const glm::vec3& c)
+{
+    ourShader.setVec3("overrideColor", c.x, c.y, c.z);
+}
+
+void RigRenderer::draw(Shader& ourShader, const Rig& rig, const Animator& animator)
+{
+    const Animator* one = &animator;
+    draw(ourShader, rig, &one, 1);
+}
+
+void RigRenderer::draw(Shader& ourShader, const Rig& rig, const Animator* const* animators, int instances)
+{
+    // every part of every instance: its joint's world matrix (the root for
+    // unjointed parts) times the part's T * S relative to that joint. The
+    // part's T * S is the same for the whole crowd, so each part is one
+    // batch over its contiguous run of instances; the fill and edge passes
+    // both reuse _models
+    const int parts = rig.getPartCount();
+    const int count = parts * instances;
+    _instances = instances;
+    _poseMats.resize(count);
+    _models.resize(count);
+    for (int p = 0; p < parts; ++p) {
+        const int joint = rig.getPartJoint(p);
+        glm::mat4* pose = &_poseMats[p * instances];
+        for (int i = 0; i < instances; ++i)
+            pose[i] = joint < 0 ? animators[i]->getRoot() : animators[i]->getDrawWorld()[joint];
+        glm::mulBatch(pose, rig.getPartLocals()[p], &_models[p * instances], instances);
+    }
+
+    // parts whose box is outside the view frustum are not submitted
+    _visible.assign(count, 1);
+    if (_cull) {
+        _bounds.resize(count);
+        for (int i = 0; i < count; ++i)
+            _bounds[i] = glm::unitCubeBounds(_models[i]);
+        glm::cullBoxes(_frustum, _bounds.data(), _visible.data(), count);
+    }
+
+    const body& myBody = rig.getBody();
+    ourShader.setBool("useOverrideColor", true);
+
+    // ---- CAP / VISIERE ----
+    setColor(ourShader, rig.getColor(CAP));
+    drawParts(ourShader, myBody, CAP_TYPES, 1);
+    setColor(ourShader, rig.getColor(VISIERE));
+    drawParts(ourShader, myBody, CAP_TYPES + 1, 1);
+
+    // ---- HEAD ----
+    setColor(ourShader, rig.getColor(HEAD));
+    drawParts(ourShader, myBody, HEAD_TYPES, 1);
+
+    // ---- TORSO ----
+    setColor(ourShader, rig.getColor(TORSO));
+    drawParts(ourShader, myBody, TORSO_TYPES, 1);
+
+    // ---- ARMS ----
+    setColor(ourShader, rig.getColor(RIGHT_UPPER_ARM));
+    drawParts(ourShader, myBody, ARM_TYPES, 4);
+
+    // ---- LEGS ----
+    setColor(ourShader, rig.getColor(RIGHT_THIGH));
+    drawParts(ourShader, myBody, LEG_TYPES, 4);
 
 
     ourShader.setVec3("overrideColor", 255.0f, 0.0f, 0.0f);
@@ -466,54 +728,10 @@ void Animator::draw(Shader& ourShader, body& myBody)
     glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     glEnable(GL_POLYGON_OFFSET_LINE);
     glPolygonOffset(-1.0f, -1.0f);
-    for (const auto& part : myBody.getParts())
-    {
-        BodyPartType type = part.getPartType();
-        glm::mat4 model(1.0f);
-        if (type == HEAD || type == TORSO) {
-            glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-            applyPivotRotation(model, torsoBase, a.torsoAngle, glm::vec3(1,0,0), pos + a.bodyOffset);
-        } else if (type == RIGHT_UPPER_ARM || type == RIGHT_LOWER_ARM ||
-                   type == LEFT_UPPER_ARM || type == LEFT_LOWER_ARM) {
-            glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-            pos = pos + a.bodyOffset + shoulderOff;
-            bool isLeftArm = (part.getX() > 0.0f);
-            bool isLower = (type == RIGHT_LOWER_ARM || type == LEFT_LOWER_ARM);
-            if (isLeftArm) {
-                if (isLower && a.leftElbow != 0.0f)
-                    applyTorsoElbowRotation(model, torsoBase, a.torsoAngle, leftShoulder, a.leftArm, a.leftArmAxis,
-                                            leftElbow, a.leftElbow, pos);
-                else
-                    applyTorsoArmRotation(model, torsoBase, a.torsoAngle, leftShoulder, a.leftArm, a.leftArmAxis, pos);
-            } else {
-                if (isLower && a.rightElbow != 0.0f)
-                    applyTorsoElbowRotation(model, torsoBase, a.torsoAngle, rightShoulder, a.rightArm, a.rightArmAxis,
-                                            rightElbow, a.rightElbow, pos);
-                else
-                    applyTorsoArmRotation(model, torsoBase, a.torsoAngle, rightShoulder, a.rightArm, a.rightArmAxis, pos);
-            }
-        } else if (type == RIGHT_THIGH || type == RIGHT_LOWER_LEG ||
-                   type == LEFT_THIGH || type == LEFT_LOWER_LEG) {
-            glm::vec3 pos(part.getX(), part.getY(), part.getZ());
-            bool isRight = (pos.x < 0.0f);
-            if (type == RIGHT_THIGH || type == LEFT_THIGH) {
-                if (isRight)
-                    applyPivotRotation(model, rightHip,  a.rightLeg,  glm::vec3(1,0,0), pos + a.bodyOffset);
-                else
-                    applyPivotRotation(model, leftHip, a.leftLeg, glm::vec3(1,0,0), pos + a.bodyOffset);
-            } else {
-                if (isRight)
-                    applyKneeRotation(model, rightHip,  a.rightLeg,  rightKnee,  a.rightKnee,  pos + a.bodyOffset);
-                else
-                    applyKneeRotation(model, leftHip, a.leftLeg, leftKnee, a.leftKnee, pos + a.bodyOffset);
-            }
-        } else {
-            continue;
-        }
-        model = glm::scale(model, part.getScale());
-        ourShader.setMat4("model", model);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-    }
+    drawParts(ourShader, myBody, HEAD_TYPES, 1);
+    drawParts(ourShader, myBody, TORSO_TYPES, 1);
+    drawParts(ourShader, myBody, ARM_TYPES, 4);
+    drawParts(ourShader, myBody, LEG_TYPES, 4);
 
     glDisable(GL_POLYGON_OFFSET_LINE);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
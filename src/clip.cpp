@@ -0,0 +1,87 @@
+#include "clip.hpp"
+#include <cassert>
+#include <cmath>
+
+
+// cubic Hermite on [0, 1]; m0 and m1 are the tangents scaled to the segment
+static float hermite(float p0, float m0, float p1, float m1, float s)
+{
+    float s2 = s * s;
+    float s3 = s2 * s;
+    return (2.0f * s3 - 3.0f * s2 + 1.0f) * p0 + (s3 - 2.0f * s2 + s) * m0
+         + (-2.0f * s3 + 3.0f * s2) * p1 + (s3 - s2) * m1;
+}
+
+
+// moves the cursor to the segment holding u: keys[k].time <= u < keys[k + 1].time.
+// Playback only ever walks forward one or two keys; a wrap or a seek back
+// restarts from the first key.
+static int seekKey(const ClipTrack& track, float u, int k)
+{
+    const Keyframe* keys = track.keys;
+    const int last = track.keyCount - 1;
+    if (k > last || u < keys[k].time)
+        k = 0;
+    while (k < last && keys[k + 1].time <= u)
+        ++k;
+    return k;
+}
+
+
+static float sampleTrack(const ClipTrack& track, float u, int k)
+{
+    const Keyframe* keys = track.keys;
+    const Keyframe& a = keys[k];
+    if (k == track.keyCount - 1) {
+        // past the last key: hold, or keep the last segment's slope going
+        if (!track.extrapolate || k == 0)
+            return a.value;
+        const Keyframe& p = keys[k - 1];
+        float slope = (a.value - p.value) / (a.time - p.time);
+        return a.value + slope * (u - a.time);
+    }
+    if (u <= a.time)
+        return a.value;
+
+    const Keyframe& b = keys[k + 1];
+    const float span = b.time - a.time;
+    const float s = (u - a.time) / span;
+    switch (a.interp) {
+        case INTERP_STEP:
+            return a.value;
+        case INTERP_LINEAR:
+            return a.value + (b.value - a.value) * s;
+        case INTERP_SMOOTH:
+            return a.value + (b.value - a.value) * easeInOut(s);
+        case INTERP_HERMITE:
+            return hermite(a.value, a.tangent * span, b.value, b.tangent * span, s);
+    }
+    return a.value;
+}
+
+
+void sampleClip(const Clip& clip, float t, ClipCursor& cursor, float* out)
+{
+    assert(clip.trackCount <= CLIP_MAX_TRACKS);
+
+    // clip-local time of the looping tracks
+    float u = t;
+    if (t > clip.duration) {
+        if (clip.loop) {
+            float period = clip.duration - clip.loopStart;
+            u = clip.loopStart + std::fmod(t - clip.loopStart, period);
+        } else {
+            u = clip.duration;
+        }
+    }
+
+    for (int i = 0; i < clip.trackCount; ++i) {
+        const ClipTrack& track = clip.tracks[i];
+        const float tu = track.extrapolate ? t : u;
+        cursor.key[i] = seekKey(track, tu, cursor.key[i]);
+        const float v = sampleTrack(track, tu, cursor.key[i]);
+        out[track.channel] = v;
+        if (track.mirror >= 0)
+            out[track.mirror] = track.mirrorScale * v;
+    }
+}
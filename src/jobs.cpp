@@ -0,0 +1,101 @@
+#include "jobs.hpp"
+#include <algorithm>
+
+JobPool::JobPool(int threads) : _round(0), _quit(false), _pending(0)
+{
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads <= 0)
+        threads = 1;
+    for (int i = 0; i < threads; ++i)
+        _queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    _workers.reserve(threads - 1);
+    for (int i = 1; i < threads; ++i)
+        _workers.emplace_back(&JobPool::workerLoop, this, i);
+}
+
+JobPool::~JobPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(_wakeLock);
+        _quit = true;
+    }
+    _wake.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+}
+
+void JobPool::dispatch(int count, int batch, void (*run)(const void*, int, int), const void* context)
+{
+    if (count <= 0)
+        return;
+    if (batch <= 0)
+        batch = 1;
+    const int jobCount = (count + batch - 1) / batch;
+    if (_workers.empty() || jobCount == 1) {
+        run(context, 0, count);
+        return;
+    }
+
+    // consecutive batches go to consecutive queues
+    _pending.store(jobCount, std::memory_order_relaxed);
+    const int threads = threadCount();
+    for (int j = 0; j < jobCount; ++j) {
+        Queue& queue = *_queues[j % threads];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.jobs.push_back({run, context, j * batch, std::min(count, (j + 1) * batch)});
+    }
+    {
+        std::lock_guard<std::mutex> guard(_wakeLock);
+        ++_round;
+    }
+    _wake.notify_all();
+
+    while (_pending.load(std::memory_order_acquire) > 0)
+        if (!runOne(0))
+            std::this_thread::yield();
+}
+
+// runs one job, from the own queue or stolen; false when every queue is empty
+bool JobPool::runOne(int self)
+{
+    const int threads = threadCount();
+    Job job;
+    bool found = false;
+    for (int k = 0; k < threads && !found; ++k) {
+        Queue& queue = *_queues[(self + k) % threads];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.jobs.empty())
+            continue;
+        // own work newest first, stolen work oldest first
+        if (k == 0) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        } else {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        found = true;
+    }
+    if (!found)
+        return false;
+    job.run(job.context, job.begin, job.end);
+    _pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobPool::workerLoop(int self)
+{
+    unsigned int seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(_wakeLock);
+            _wake.wait(guard, [&] { return _quit || _round != seen; });
+            if (_quit)
+                return;
+            seen = _round;
+        }
+        while (runOne(self))
+            ;
+    }
+}
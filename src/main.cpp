@@ -1,8 +1,11 @@
 #include "include.hpp"
 #include "animation.hpp"
+#include "pool.hpp"
+#include "jobs.hpp"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window, Animator &animator);
+void processCrowdInput(GLFWwindow *window, CharacterPool &characters, std::vector<CharacterHandle> &crowd);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 
 // settings
@@ -12,65 +15,22 @@ const unsigned int SCR_HEIGHT = 600;
 // Orbit camera: centred on the character, orbited with WASD/arrows, zoomed with scroll.
 Camera camera(glm::vec3(0.0f, -4.0f, 0.0f)); // target ≈ character centre
 
+// crowd mode (C): characters spawned in a grid around the player, and how
+// many of them one job updates and poses
+const int CROWD_SIZE = 1024;
+const int CROWD_BATCH = 32;
+
 // timing
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
-
-std::map<glm::vec3, int> setAtachementPoints(const glm::vec3& cubePosition, std::vector<int> attachmentStates)
-{
-    std::map<glm::vec3, int> attachmentPoints;
-
-    // gauche/droite | bas/haut | arriere/avant
-    // up right
-    glm::vec3 point = cubePosition + glm::vec3(-1.0f, 1.0f, 0.0f);
-    attachmentPoints[point] = attachmentStates[0];
-
-    // up back
-    point = cubePosition + glm::vec3(0.0f, 1.0f, -1.0f);
-    attachmentPoints[point] = attachmentStates[1];
-
-    // up left
-    point = cubePosition + glm::vec3(1.0f, 1.0f, 0.0f);
-    attachmentPoints[point] = attachmentStates[2];
-
-    // up front
-    point = cubePosition + glm::vec3(0.0f, 1.0f, 1.0f);
-    attachmentPoints[point] = attachmentStates[3];
-
-    // right front
-    point = cubePosition + glm::vec3(-1.0f, 0.0f, 1.0f);
-    attachmentPoints[point] = attachmentStates[4];
-
-    // right back
-    point = cubePosition + glm::vec3(-1.0f, 0.0f, -1.0f);
-    attachmentPoints[point] = attachmentStates[5];
-
-    // left back
-    point = cubePosition + glm::vec3(1.0f, 0.0f, -1.0f);
-    attachmentPoints[point] = attachmentStates[6];
-
-    // left front
-    point = cubePosition + glm::vec3(1.0f, 0.0f, 1.0f);
-    attachmentPoints[point] = attachmentStates[7];
-
-    // down right
-    point = cubePosition + glm::vec3(-1.0f, -1.0f, 0.0f);
-    attachmentPoints[point] = attachmentStates[8];
-
-    // down back
-    point = cubePosition + glm::vec3(0.0f, -1.0f, -1.0f);
-    attachmentPoints[point] = attachmentStates[9];
-
-    // down left
-    point = cubePosition + glm::vec3(1.0f, -1.0f, 0.0f);
-    attachmentPoints[point] = attachmentStates[10];
-
-    // down front
-    point = cubePosition + glm::vec3(0.0f, -1.0f, 1.0f);
-    attachmentPoints[point] = attachmentStates[11];
-
-    return attachmentPoints;
-}
+// animation advances in fixed steps of 1 / SIM_RATE seconds whatever the
+// display rate; frames drawn between two steps interpolate the poses
+const float SIM_RATE = 60.0f;
+// longest frame time fed to the simulation, so a stall is not replayed step by step
+const float MAX_FRAME_TIME = 0.25f;
+// pack the baked tables: about 12x less memory (270 KB to 23 KB), within about
+// 0.1 degree and 0.002 units, but sampling costs 3-5x more on the dense clips
+const bool PACK_BAKED_POSES = false;
 
 int main()
 {
@@ -169,135 +129,13 @@ int main()
         -0.5f, -0.5f, -0.5f,  0.0f, 1.0f, 1.0f
     };
 
-    body myBody;
-
-    // up, down, right, left, front, back
-    // left/right | up/down | front/back
-    const float HEAD_SCALE = 1.0f;
-    const float TORSO_SCALE = 3.0f; // "corp = 3"
-    const float ARM_SCALE = 2.0f;   // "bras = 2"
-    const float LEG_SCALE = 2.0f;   // "jambe = 2"
-    const float BASE = float(SIZE); // unit cube size
-    // half extents of each part (world units)
-    const float head_half = (0.5f * HEAD_SCALE * BASE) - (BASE / 4);
-    const float torso_half = 0.5f * TORSO_SCALE * BASE;
-    const float arm_half = 0.5f * ARM_SCALE * BASE;
-    const float leg_half = 0.5f * LEG_SCALE * BASE;
-
-    // choose head center at y = 0.0
-    glm::vec3 headCenter = {0.0f, 0.0f, 0.0f};
-
-    // place torso directly below the head so they touch: headBottom == torsoTop
-    glm::vec3 torsoCenter = {0.0f, headCenter.y - (head_half + torso_half), 0.0f};
-
-    // arms attach at the vertical position near torso top (shoulder)
-    float arm_attach_y = torsoCenter.y + torso_half - arm_half; // align upper-arm top with torso top
-
-    // horizontal offset so arms sit beside the torso
-    float arm_offset_x = torso_half + arm_half - (BASE * 0.5); // directly adjacent to torso
-
-    glm::vec3 rightUpperArmCenter = {-arm_offset_x, arm_attach_y, 0.0f};
-    glm::vec3 leftUpperArmCenter = {arm_offset_x, arm_attach_y, 0.0f};
-    // lower arms positioned below upper arms so they touch
-    glm::vec3 rightLowerArmCenter = {rightUpperArmCenter.x, rightUpperArmCenter.y - (arm_half + arm_half), 0.0f};
-    glm::vec3 leftLowerArmCenter = {leftUpperArmCenter.x, leftUpperArmCenter.y - (arm_half + arm_half), 0.0f};
-
-    // legs attach under the torso
-    float leg_attach_x = 0.5f * BASE; // keep legs at +/-0.5 like original layout
-    glm::vec3 rightThighCenter = {-leg_attach_x, torsoCenter.y - (torso_half + leg_half), 0.0f};
-    glm::vec3 leftThighCenter = {leg_attach_x, torsoCenter.y - (torso_half + leg_half), 0.0f};
-    glm::vec3 rightLowerLegCenter = {rightThighCenter.x, rightThighCenter.y - (leg_half + leg_half), 0.0f};
-    glm::vec3 leftLowerLegCenter = {leftThighCenter.x, leftThighCenter.y - (leg_half + leg_half), 0.0f};
-    glm::vec3 cap = {0.0f, headCenter.y + (BASE / 2), 0.0f};
-    glm::vec3 visiere = {0.0f, headCenter.y + (BASE / 4), BASE - (BASE / 4)};
-
-    // create parts with computed positions and sizes
-    std::map<glm::vec3, int> attachmentPoints;
-
-    attachmentPoints = setAtachementPoints(headCenter, {0, 0, 0, 0,
-                                                        0, 0, 0, 0,
-                                                        0, 0, 0, 2});
-    bodyPart head(headCenter.x, headCenter.y, headCenter.z, BodyPartType::HEAD, attachmentPoints);
-    head.setSize(glm::vec3(HEAD_SCALE * BASE, BASE / 2, BASE));
-
-    attachmentPoints = setAtachementPoints(torsoCenter, {2, 0, 2, 2,
-                                                         0, 0, 0, 0,
-                                                         0, 0, 0, 2});
-    bodyPart torso(torsoCenter.x, torsoCenter.y, torsoCenter.z, BodyPartType::TORSO, attachmentPoints);
-    torso.setSize(glm::vec3(TORSO_SCALE * BASE, TORSO_SCALE * BASE, BASE));
-
-    // right arm
-    attachmentPoints = setAtachementPoints(rightUpperArmCenter, {0, 0, 2, 0,
-                                                                0, 0, 0, 0,
-                                                                0, 0, 0, 2});
-    bodyPart rightArm1(rightUpperArmCenter.x, rightUpperArmCenter.y, rightUpperArmCenter.z, BodyPartType::RIGHT_UPPER_ARM, attachmentPoints);
-    rightArm1.setSize(glm::vec3(BASE, ARM_SCALE * BASE, BASE));
-    attachmentPoints = setAtachementPoints(rightLowerArmCenter, {0, 0, 0, 2,
-                                                                0, 0, 0, 0,
-                                                                0, 0, 0, 0});
-    bodyPart rightArm2(rightLowerArmCenter.x, rightLowerArmCenter.y, rightLowerArmCenter.z, BodyPartType::RIGHT_LOWER_ARM, attachmentPoints);
-    rightArm2.setSize(glm::vec3(BASE, ARM_SCALE * BASE, BASE));
-
-    // left arm
-    attachmentPoints = setAtachementPoints(leftUpperArmCenter, {2, 0, 0, 0,
-                                                                 0, 0, 0, 0,
-                                                                 0, 0, 0, 2});
-    bodyPart leftArm1(leftUpperArmCenter.x, leftUpperArmCenter.y, leftUpperArmCenter.z, BodyPartType::LEFT_UPPER_ARM, attachmentPoints);
-    leftArm1.setSize(glm::vec3(BASE, ARM_SCALE * BASE, BASE));
-    attachmentPoints = setAtachementPoints(leftLowerArmCenter, {0, 0, 0, 2,
-                                                                0, 0, 0, 0,
-                                                                0, 0, 0, 0});
-    bodyPart leftArm2(leftLowerArmCenter.x, leftLowerArmCenter.y, leftLowerArmCenter.z, BodyPartType::LEFT_LOWER_ARM, attachmentPoints);
-    leftArm2.setSize(glm::vec3(BASE, ARM_SCALE * BASE, BASE));
-
-    // right leg (thigh + lower)
-    attachmentPoints = setAtachementPoints(rightThighCenter, {0, 0, 0, 2,
-                                                             0, 0, 0, 0,
-                                                             0, 0, 0, 2});
-    bodyPart rightLeg1(rightThighCenter.x, rightThighCenter.y, rightThighCenter.z, BodyPartType::RIGHT_THIGH, attachmentPoints);
-    rightLeg1.setSize(glm::vec3(BASE, LEG_SCALE * BASE, BASE));
-    attachmentPoints = setAtachementPoints(rightLowerLegCenter, {0, 0, 0, 2,
-                                                                0, 0, 0, 0,
-                                                                0, 0, 0, 0});
-    bodyPart rightLeg2(rightLowerLegCenter.x, rightLowerLegCenter.y, rightLowerLegCenter.z, BodyPartType::RIGHT_LOWER_LEG, attachmentPoints);
-    rightLeg2.setSize(glm::vec3(BASE, LEG_SCALE * BASE, BASE));
-
-    // left leg
-    attachmentPoints = setAtachementPoints(leftThighCenter, {0, 0, 0, 2,
-                                                              0, 0, 0, 0,
-                                                              0, 0, 0, 2});
-    bodyPart leftLeg1(leftThighCenter.x, leftThighCenter.y, leftThighCenter.z, BodyPartType::LEFT_THIGH, attachmentPoints);
-    leftLeg1.setSize(glm::vec3(BASE, LEG_SCALE * BASE, BASE));
-    attachmentPoints = setAtachementPoints(leftLowerLegCenter, {0, 0, 0, 2,
-                                                                 0, 0, 0, 0,
-                                                                 0, 0, 0, 0});
-    bodyPart leftLeg2(leftLowerLegCenter.x, leftLowerLegCenter.y, leftLowerLegCenter.z, BodyPartType::LEFT_LOWER_LEG, attachmentPoints);
-    leftLeg2.setSize(glm::vec3(BASE, LEG_SCALE * BASE, BASE));
-    
-    attachmentPoints = setAtachementPoints(cap, {0, 0, 0, 0,
-                                                                 0, 0, 0, 0,
-                                                                 1, 1, 1, 1});
-    bodyPart capPart(cap.x, cap.y, cap.z, BodyPartType::CAP, attachmentPoints);
-    capPart.setSize(glm::vec3(BASE, HEAD_SCALE * (BASE / 2), BASE));
-    attachmentPoints = setAtachementPoints(visiere, {1, 0, 0, 0,
-                                                                 1, 1, 0, 0,
-                                                                 1, 0, 0, 0});
-    bodyPart visierePart(visiere.x, visiere.y, visiere.z, BodyPartType::VISIERE, attachmentPoints);
-    visierePart.setSize(glm::vec3(BASE, 0.1f, BASE / 2));
-
-    // add to body
-    myBody.addPart(head);
-    myBody.addPart(torso);
-    myBody.addPart(rightArm1);
-    myBody.addPart(rightArm2);
-    myBody.addPart(leftArm1);
-    myBody.addPart(leftArm2);
-    myBody.addPart(rightLeg1);
-    myBody.addPart(rightLeg2);
-    myBody.addPart(leftLeg1);
-    myBody.addPart(leftLeg2);
-    myBody.addPart(capPart);
-    myBody.addPart(visierePart);
+    // load the rig description; rigs/human.rig is compiled to a binary cache
+    // on first use, and the built-in layout (rig.hpp) is the fallback
+    RigDef rigDef = RIG_DEFAULT;
+    if (!loadRig(FileSystem::getPath("rigs/human.rig"), rigDef))
+        std::cout << "Using the built-in rig" << std::endl;
+    // shared by every character drawn with it
+    const Rig rig(rigDef);
 
     unsigned int VBO, VAO;
     glGenVertexArrays(1, &VAO);
@@ -323,7 +161,23 @@ int main()
 
     // render loop
     // -----------
-    Animator animator;
+    // every character lives in the pool; slots are allocated once, here
+    CharacterPool characters(CROWD_SIZE + 1);
+    const CharacterHandle player = characters.spawn(glm::mat4(1.0f));
+    std::vector<CharacterHandle> crowd;
+    crowd.reserve(CROWD_SIZE);
+    // characters are updated and posed on every hardware thread
+    JobPool jobs;
+    const float simStep = 1.0f / SIM_RATE;
+    float simAccumulator = 0.0f;
+    RigRenderer renderer;
+    std::vector<const Animator*> drawList;
+    drawList.reserve(CROWD_SIZE + 1);
+    // looping clips are played back from tables sampled at this rate
+    BakedPoses bakedPoses;
+    bakedPoses.bake(60.0f);
+    if (PACK_BAKED_POSES)
+        bakedPoses.compress(0.002f, 0.002f);
     while (!glfwWindowShouldClose(window))
     {
         // per-frame time logic
@@ -333,7 +187,8 @@ int main()
 
         // input
         // -----
-    processInput(window, animator);
+    processInput(window, *characters.get(player));
+    processCrowdInput(window, characters, crowd);
         // ------
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // also clear the depth buffer now!
@@ -350,12 +205,41 @@ int main()
         // pass transformation matrices to the shader
         ourShader.setMat4("projection", projection); // note: currently we set the projection matrix each frame, but since the projection matrix rarely changes it's often best practice to set it outside the main loop only once.
         ourShader.setMat4("view", view);
+        renderer.setViewProjection(projection * view);
 
         // render boxes
         glBindVertexArray(VAO);
 
-        animator.update(deltaTime);
-        animator.draw(ourShader, myBody);
+        // every pose is finished before drawing starts; the draws only read
+        // the joint matrices the jobs left in each animator
+        simAccumulator += std::min(deltaTime, MAX_FRAME_TIME);
+        while (simAccumulator >= simStep)
+        {
+            jobs.parallelFor(characters.size(), CROWD_BATCH, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i)
+                {
+                    Animator& character = characters.getLive(i);
+                    character.update(simStep);
+                    character.evaluate(rig, &bakedPoses);
+                }
+            });
+            simAccumulator -= simStep;
+        }
+        const float alpha = simAccumulator / simStep;
+        jobs.parallelFor(characters.size(), CROWD_BATCH, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i)
+                characters.getLive(i).interpolate(rig, alpha);
+        });
+        // the whole crowd is drawn in one call, part by part
+        drawList.clear();
+        for (int i = 0; i < characters.size(); ++i)
+        {
+            // characters spawned since the last step have no pose yet
+            const Animator& character = characters.getLive(i);
+            if (character.isPosed())
+                drawList.push_back(&character);
+        }
+        renderer.draw(ourShader, rig, drawList.data(), static_cast<int>(drawList.size()));
         // myBody.draw_wall(ourShader);
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
@@ -414,12 +298,51 @@ void processInput(GLFWwindow *window, Animator &animator)
         } else if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
             animator.setState(EAGLE_FLIGHT);
             pressedAnimationKey = true;
+        } else if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS) {
+            // toggles a wave of the left arm over whatever the body plays
+            static int waveLayer = -1;
+            if (waveLayer < 0)
+                waveLayer = animator.addLayer(WAVING, MASK_LEFT_ARM, LAYER_OVERRIDE);
+            else {
+                animator.removeLayer(waveLayer);
+                waveLayer = -1;
+            }
+            pressedAnimationKey = true;
         }
     }
-    if (glfwGetKey(window, GLFW_KEY_0) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_1) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_2) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_3) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_4) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_5) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_6) == GLFW_RELEASE)
+    if (glfwGetKey(window, GLFW_KEY_0) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_1) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_2) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_3) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_4) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_5) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_6) == GLFW_RELEASE && glfwGetKey(window, GLFW_KEY_7) == GLFW_RELEASE)
         pressedAnimationKey = false;
 }
 
+// C spawns the crowd, pressing it again clears it
+void processCrowdInput(GLFWwindow *window, CharacterPool &characters, std::vector<CharacterHandle> &crowd)
+{
+    static bool pressedCrowdKey = false;
+    const bool pressed = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+    if (pressed && !pressedCrowdKey)
+    {
+        if (crowd.empty())
+        {
+            // a square grid in front of the player, each row on its own clip
+            const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(CROWD_SIZE))));
+            const Animations states[] = {WAVING, WALKING, JUMPING, T_POSE, NARUTO_RUN};
+            for (int i = 0; i < CROWD_SIZE; ++i)
+            {
+                const int row = i / side, col = i % side;
+                glm::vec3 pos((col - side / 2) * 4.0f, 0.0f, -8.0f - row * 4.0f);
+                crowd.push_back(characters.spawn(glm::translate(glm::mat4(1.0f), pos), states[row % 5]));
+            }
+        }
+        else
+        {
+            for (CharacterHandle handle : crowd)
+                characters.despawn(handle);
+            crowd.clear();
+        }
+    }
+    pressedCrowdKey = pressed;
+}
+
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
 // ---------------------------------------------------------------------------------------------
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
@@ -0,0 +1,69 @@
+#include "pool.hpp"
+
+CharacterPool::CharacterPool(int capacity)
+    : _slots(capacity), _generations(capacity, 1), _livePos(capacity, -1)
+{
+    _free.reserve(capacity);
+    _live.reserve(capacity);
+    // lowest slots are handed out first
+    for (int i = capacity - 1; i >= 0; --i)
+        _free.push_back(i);
+}
+
+CharacterHandle CharacterPool::spawn(const glm::mat4& root, Animations state)
+{
+    CharacterHandle handle;
+    if (_free.empty())
+        return handle;
+    const int slot = _free.back();
+    _free.pop_back();
+    _livePos[slot] = static_cast<int>(_live.size());
+    _live.push_back(slot);
+
+    // reset in place, the slot keeps its storage
+    Animator& a = _slots[slot];
+    a = Animator();
+    a.setRoot(root);
+    a.setState(state, 0.0f);
+
+    handle.index = static_cast<unsigned int>(slot);
+    handle.generation = _generations[slot];
+    return handle;
+}
+
+bool CharacterPool::despawn(CharacterHandle handle)
+{
+    if (!isAlive(handle))
+        return false;
+    const int slot = static_cast<int>(handle.index);
+
+    // swap-remove from the dense live list
+    const int pos = _livePos[slot];
+    const int last = _live.back();
+    _live[pos] = last;
+    _livePos[last] = pos;
+    _live.pop_back();
+    _livePos[slot] = -1;
+
+    // invalidate outstanding handles, skipping the never-live generation 0
+    if (++_generations[slot] == 0)
+        _generations[slot] = 1;
+    _free.push_back(slot);
+    return true;
+}
+
+bool CharacterPool::isAlive(CharacterHandle handle) const
+{
+    return handle.generation != 0 && handle.index < _slots.size()
+           && _generations[handle.index] == handle.generation && _livePos[handle.index] >= 0;
+}
+
+Animator* CharacterPool::get(CharacterHandle handle)
+{
+    return isAlive(handle) ? &_slots[handle.index] : nullptr;
+}
+
+const Animator* CharacterPool::get(CharacterHandle handle) const
+{
+    return isAlive(handle) ? &_slots[handle.index] : nullptr;
+}
@@ -0,0 +1,283 @@
+#include "pose.hpp"
+#include <algorithm>
+#include <cmath>
+
+// out may alias a or b: each joint is read before it is written
+void lerpPose(const Pose& a, const Pose& b, float t, Pose& out)
+{
+    for (int j = 0; j < JOINT_COUNT; ++j) {
+        out.rot[j] = glm::nlerp(a.rot[j], b.rot[j], t);
+        out.trans[j] = glm::lerp(a.trans[j], b.trans[j], t);
+    }
+}
+
+
+// ---- packed poses ----
+
+constexpr int ROT_QUANT = 0x7fff;   // 15 bits per smallest-three component
+constexpr int TRANS_QUANT = 0xffff; // 16 bits per translation axis
+
+static void toArray(const glm::quat& q, float* v)
+{
+    v[0] = q.w;
+    v[1] = q.x;
+    v[2] = q.y;
+    v[3] = q.z;
+}
+
+static int largestComponent(const float* v)
+{
+    int largest = 0;
+    for (int c = 1; c < 4; ++c)
+        if (std::fabs(v[c]) > std::fabs(v[largest]))
+            largest = c;
+    return largest;
+}
+
+// q and -q are the same rotation; the packed one has its largest component
+// positive, so that component can be rebuilt from the other three
+static glm::quat canonical(const glm::quat& q)
+{
+    float v[4];
+    toArray(q, v);
+    if (v[largestComponent(v)] < 0.0f)
+        return glm::quat(-q.w, -q.x, -q.y, -q.z);
+    return q;
+}
+
+static unsigned short quantize(float x, float base, float scale, int quant)
+{
+    if (scale <= 0.0f)
+        return 0;
+    float q = std::round((x - base) / scale);
+    return static_cast<unsigned short>(std::min(std::max(q, 0.0f), static_cast<float>(quant)));
+}
+
+// base and scale cover [min, max] of each of n components of values
+static void fitRange(const float* values, int count, int n, int quant, float* base, float* scale)
+{
+    for (int c = 0; c < n; ++c) {
+        float lo = values[c], hi = values[c];
+        for (int i = 1; i < count; ++i) {
+            lo = std::min(lo, values[i * n + c]);
+            hi = std::max(hi, values[i * n + c]);
+        }
+        base[c] = lo;
+        scale[c] = (hi - lo) / quant;
+    }
+}
+
+static void encodeRotation(const glm::quat& q, const float* base, const float* scale, unsigned short* words)
+{
+    float v[4];
+    toArray(q, v);
+    const int largest = largestComponent(v);
+    int n = 0;
+    for (int c = 0; c < 4; ++c)
+        if (c != largest)
+            words[n++] = quantize(v[c], base[c], scale[c], ROT_QUANT);
+    // the index of the dropped component goes in the spare top bits
+    words[0] |= static_cast<unsigned short>((largest & 1) << 15);
+    words[1] |= static_cast<unsigned short>((largest >> 1) << 15);
+}
+
+// not normalized: quantization leaves it a few 1e-5 off unit length
+static glm::quat decodeRotation(const unsigned short* words, const float* base, const float* scale)
+{
+    const int largest = (words[0] >> 15) | ((words[1] >> 15) << 1);
+    float v[4];
+    float sum = 0.0f;
+    int n = 0;
+    for (int c = 0; c < 4; ++c) {
+        if (c == largest)
+            continue;
+        v[c] = base[c] + (words[n++] & ROT_QUANT) * scale[c];
+        sum += v[c] * v[c];
+    }
+    v[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+    return glm::quat(v[0], v[1], v[2], v[3]);
+}
+
+static void encodeTranslation(const glm::vec3& t, const float* base, const float* scale, unsigned short* words)
+{
+    words[0] = quantize(t.x, base[0], scale[0], TRANS_QUANT);
+    words[1] = quantize(t.y, base[1], scale[1], TRANS_QUANT);
+    words[2] = quantize(t.z, base[2], scale[2], TRANS_QUANT);
+}
+
+static glm::vec3 decodeTranslation(const unsigned short* words, const float* base, const float* scale)
+{
+    return glm::vec3(base[0] + words[0] * scale[0], base[1] + words[1] * scale[1], base[2] + words[2] * scale[2]);
+}
+
+// angle between two rotations, from the chord so it stays accurate near 0
+static float rotationDistance(const glm::quat& a, const glm::quat& b)
+{
+    const float k = glm::dot(a, b) < 0.0f ? -1.0f : 1.0f;
+    const float dw = a.w - k * b.w, dx = a.x - k * b.x, dy = a.y - k * b.y, dz = a.z - k * b.z;
+    const float chord = std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz);
+    return 4.0f * std::asin(std::min(1.0f, 0.5f * chord));
+}
+
+static float translationDistance(const glm::vec3& a, const glm::vec3& b)
+{
+    return glm::length(a - b);
+}
+
+// frames kept as keys: 0, frameCount, and as few in between as lerping the
+// decoded keys allows while every original frame stays within maxError. A
+// track that holds one value keeps frame 0 only.
+template <typename T, typename Lerp, typename Distance>
+static void reduceKeys(const T* original, const T* decoded, int frameCount, float maxError,
+                       Lerp lerp, Distance distance, std::vector<int>& keys)
+{
+    keys.clear();
+    keys.push_back(0);
+    bool constant = true;
+    for (int i = 1; i <= frameCount && constant; ++i)
+        constant = distance(decoded[0], original[i]) <= maxError;
+    if (constant)
+        return;
+
+    auto spanFits = [&](int a, int b) {
+        for (int i = a + 1; i < b; ++i)
+            if (distance(lerp(decoded[a], decoded[b], float(i - a) / float(b - a)), original[i]) > maxError)
+                return false;
+        return true;
+    };
+    // greedy: stretch each segment until one more frame would break the bound
+    int a = 0;
+    while (a < frameCount) {
+        int b = a + 1;
+        while (b < frameCount && spanFits(a, b + 1))
+            ++b;
+        keys.push_back(b);
+        a = b;
+    }
+}
+
+
+void PackedPoses::pack(const Pose* frames, int frameCount, float rotError, float transError)
+{
+    assert(frameCount > 0 && frameCount <= 0xffff);
+    _frameCount = frameCount;
+    _keys.clear();
+
+    const int count = frameCount + 1;
+    std::vector<glm::quat> rot(count), rotDecoded(count);
+    std::vector<glm::vec3> trans(count), transDecoded(count);
+    std::vector<float> values(count * 4);
+    std::vector<unsigned short> words(count * 3);
+    std::vector<int> keys;
+
+    auto appendKeys = [&](Track& track) {
+        track.first = static_cast<int>(_keys.size());
+        track.count = static_cast<int>(keys.size());
+        for (int k : keys)
+            _keys.push_back({static_cast<unsigned short>(k), {words[k * 3], words[k * 3 + 1], words[k * 3 + 2]}});
+    };
+
+    for (int j = 0; j < JOINT_COUNT; ++j) {
+        Track& r = _rot[j];
+        for (int i = 0; i < count; ++i) {
+            rot[i] = canonical(frames[i].rot[j]);
+            toArray(rot[i], &values[i * 4]);
+        }
+        fitRange(values.data(), count, 4, ROT_QUANT, r.base, r.scale);
+        for (int i = 0; i < count; ++i) {
+            encodeRotation(rot[i], r.base, r.scale, &words[i * 3]);
+            rotDecoded[i] = glm::normalize(decodeRotation(&words[i * 3], r.base, r.scale));
+        }
+        reduceKeys(rot.data(), rotDecoded.data(), frameCount, rotError, glm::nlerp, rotationDistance, keys);
+        appendKeys(r);
+        _rotHeld[j] = rotDecoded[0];
+
+        Track& t = _trans[j];
+        for (int i = 0; i < count; ++i) {
+            trans[i] = frames[i].trans[j];
+            values[i * 3] = trans[i].x;
+            values[i * 3 + 1] = trans[i].y;
+            values[i * 3 + 2] = trans[i].z;
+        }
+        fitRange(values.data(), count, 3, TRANS_QUANT, t.base, t.scale);
+        for (int i = 0; i < count; ++i) {
+            encodeTranslation(trans[i], t.base, t.scale, &words[i * 3]);
+            transDecoded[i] = decodeTranslation(&words[i * 3], t.base, t.scale);
+        }
+        reduceKeys(trans.data(), transDecoded.data(), frameCount, transError,
+                   [](const glm::vec3& a, const glm::vec3& b, float s) { return glm::lerp(a, b, s); },
+                   translationDistance, keys);
+        appendKeys(t);
+        _transHeld[j] = transDecoded[0];
+    }
+    _keys.shrink_to_fit();
+}
+
+
+// first key of the segment holding frame f, among count >= 2 keys
+template <typename Key>
+static int findKey(const Key* keys, int count, float f)
+{
+    int lo = 0, hi = count - 2;
+    while (lo < hi) {
+        const int mid = (lo + hi + 1) / 2;
+        if (keys[mid].frame <= f)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+
+// first key of the segment holding f, from the cursor's key k. Playback
+// only walks forward a key or two; a wrap, a seek back or a longer jump
+// searches again.
+template <typename Key>
+static int seekKey(const Key* keys, int count, float f, int k)
+{
+    const int last = count - 2;
+    if (k > last || f < keys[k].frame)
+        return findKey(keys, count, f);
+    for (int n = 0; k < last && keys[k + 1].frame <= f; ++k)
+        if (++n > 2)
+            return findKey(keys, count, f);
+    return k;
+}
+
+
+void PackedPoses::sample(float f, PackedCursor& cursor, Pose& pose, JointMask mask) const
+{
+    for (int j = 0; j < JOINT_COUNT; ++j) {
+        if (!(mask & jointBit(j)))
+            continue;
+
+        const Track& r = _rot[j];
+        if (r.count == 1) {
+            pose.rot[j] = _rotHeld[j];
+        } else {
+            const Key* keys = _keys.data() + r.first;
+            const int k = cursor.key[j] = seekKey(keys, r.count, f, cursor.key[j]);
+            const float s = (f - keys[k].frame) / float(keys[k + 1].frame - keys[k].frame);
+            pose.rot[j] = glm::nlerp(decodeRotation(keys[k].words, r.base, r.scale),
+                                     decodeRotation(keys[k + 1].words, r.base, r.scale), s);
+        }
+
+        const Track& t = _trans[j];
+        if (t.count == 1) {
+            pose.trans[j] = _transHeld[j];
+        } else {
+            const Key* keys = _keys.data() + t.first;
+            const int k = cursor.key[JOINT_COUNT + j] = seekKey(keys, t.count, f, cursor.key[JOINT_COUNT + j]);
+            const float s = (f - keys[k].frame) / float(keys[k + 1].frame - keys[k].frame);
+            pose.trans[j] = glm::lerp(decodeTranslation(keys[k].words, t.base, t.scale),
+                                      decodeTranslation(keys[k + 1].words, t.base, t.scale), s);
+        }
+    }
+}
+
+
+size_t PackedPoses::byteSize() const
+{
+    return sizeof(*this) + _keys.capacity() * sizeof(Key);
+}
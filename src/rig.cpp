@@ -0,0 +1,256 @@
+#include "rig.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+// binary cache layout: a small header followed by the RigDef bytes
+struct RigBinary
+{
+    char magic[4];
+    unsigned int version;
+    unsigned int size;
+    RigDef rig;
+};
+
+static const char RIG_MAGIC[4] = {'H', 'R', 'I', 'G'};
+
+template <int N>
+static int findName(const char* const (&names)[N], const std::string& name)
+{
+    for (int i = 0; i < N; ++i)
+        if (name == names[i])
+            return i;
+    return -1;
+}
+
+// modification time of a file, -1 if it does not exist
+static long long fileTime(const std::string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return -1;
+    return static_cast<long long>(st.st_mtime);
+}
+
+// what makes rig unusable, nullptr when every index in it is in range. Run
+// on both load paths: FK and the renderer index with these values unchecked
+static const char* rigProblem(const RigDef& rig)
+{
+    if (rig.partCount < 0 || rig.partCount > RIG_MAX_PARTS)
+        return "has a bad part count";
+    for (int j = 0; j < JOINT_COUNT; ++j)
+        if (rig.joints[j].parent < -1)
+            return "has a joint with an unknown parent";
+    if (!rigJointsSorted(rig))
+        return "has a joint before its parent";
+    for (int i = 0; i < rig.partCount; ++i)
+    {
+        const PartLayout& part = rig.parts[i];
+        if (part.type < 0 || part.type >= BODY_PART_TYPE_COUNT)
+            return "has a part of unknown type";
+        if (part.joint < -1 || part.joint >= JOINT_COUNT)
+            return "has a part on an unknown joint";
+        if (part.parent < -1 || part.parent >= rig.partCount)
+            return "has a part with an unknown parent";
+        for (int d = 0; d < ATTACH_DIR_COUNT; ++d)
+            if (part.attachments[d] < ATTACH_NONE || part.attachments[d] > ATTACH_MOBILE)
+                return "has a part with a bad attachment state";
+    }
+    return nullptr;
+}
+
+// text format, one record per line, '#' starts a comment:
+//   joint <name> <parent name | -> <pivot x y z>
+//   part <type> <center x y z> <size x y z> <parent part index | -> <joint name> <12 attachment states>
+// every joint of RigJoint must be given once; parts keep their file order
+bool parseRigText(const std::string& textPath, RigDef& rig)
+{
+    std::ifstream file(textPath);
+    if (!file)
+    {
+        std::cout << "Failed to open rig file: " << textPath << std::endl;
+        return false;
+    }
+
+    RigDef out{};
+    bool seen[JOINT_COUNT] = {};
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNo;
+        std::string::size_type hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+        std::istringstream in(line);
+        std::string kind;
+        if (!(in >> kind))
+            continue;
+
+        bool ok = false;
+        if (kind == "joint")
+        {
+            std::string name, parent;
+            glm::vec3 pivot;
+            if (in >> name >> parent >> pivot.x >> pivot.y >> pivot.z)
+            {
+                int j = findName(RIG_JOINT_NAMES, name);
+                int p = parent == "-" ? -1 : findName(RIG_JOINT_NAMES, parent);
+                ok = j >= 0 && !seen[j] && (parent == "-" || p >= 0);
+                if (ok)
+                {
+                    seen[j] = true;
+                    out.joints[j].parent = p;
+                    out.joints[j].pivot = pivot;
+                }
+            }
+        }
+        else if (kind == "part" && out.partCount < RIG_MAX_PARTS)
+        {
+            std::string type, parent, joint;
+            PartLayout& part = out.parts[out.partCount];
+            if (in >> type >> part.center.x >> part.center.y >> part.center.z
+                   >> part.size.x >> part.size.y >> part.size.z >> parent >> joint)
+            {
+                int t = findName(BODY_PART_TYPE_NAMES, type);
+                int j = findName(RIG_JOINT_NAMES, joint);
+                char* end = nullptr;
+                part.parent = parent == "-" ? -1 : static_cast<int>(std::strtol(parent.c_str(), &end, 10));
+                ok = t >= 0 && j >= 0 && (parent == "-" || (*end == '\0' && part.parent >= 0));
+                for (int d = 0; ok && d < ATTACH_DIR_COUNT; ++d)
+                    ok = static_cast<bool>(in >> part.attachments[d]) && part.attachments[d] >= ATTACH_NONE
+                         && part.attachments[d] <= ATTACH_MOBILE;
+                if (ok)
+                {
+                    part.type = t;
+                    part.joint = j;
+                    ++out.partCount;
+                }
+            }
+        }
+        if (!ok)
+        {
+            std::cout << "Invalid rig record at " << textPath << ":" << lineNo << std::endl;
+            return false;
+        }
+    }
+
+    for (int j = 0; j < JOINT_COUNT; ++j)
+        if (!seen[j])
+        {
+            std::cout << "Rig file " << textPath << " has no joint " << RIG_JOINT_NAMES[j] << std::endl;
+            return false;
+        }
+    if (const char* problem = rigProblem(out))
+    {
+        std::cout << "Rig file " << textPath << " " << problem << std::endl;
+        return false;
+    }
+
+    rig = out;
+    return true;
+}
+
+bool readRigBinary(const std::string& binaryPath, RigDef& rig)
+{
+    std::FILE* file = std::fopen(binaryPath.c_str(), "rb");
+    if (!file)
+        return false;
+    RigBinary bin;
+    bool ok = std::fread(&bin, sizeof(bin), 1, file) == 1
+              && std::memcmp(bin.magic, RIG_MAGIC, sizeof(RIG_MAGIC)) == 0
+              && bin.version == RIG_BINARY_VERSION && bin.size == sizeof(RigDef);
+    std::fclose(file);
+    if (!ok)
+        return false;
+    // a header that matches does not make the body trustworthy
+    if (const char* problem = rigProblem(bin.rig))
+    {
+        std::cout << "Rig cache " << binaryPath << " " << problem << ", ignoring it" << std::endl;
+        return false;
+    }
+    rig = bin.rig;
+    return true;
+}
+
+bool writeRigBinary(const std::string& binaryPath, const RigDef& rig)
+{
+    RigBinary bin;
+    std::memcpy(bin.magic, RIG_MAGIC, sizeof(RIG_MAGIC));
+    bin.version = RIG_BINARY_VERSION;
+    bin.size = sizeof(RigDef);
+    bin.rig = rig;
+
+    std::FILE* file = std::fopen(binaryPath.c_str(), "wb");
+    if (!file)
+    {
+        std::cout << "Failed to write rig cache: " << binaryPath << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&bin, sizeof(bin), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+        std::cout << "Failed to write rig cache: " << binaryPath << std::endl;
+    return ok;
+}
+
+bool loadRig(const std::string& textPath, RigDef& rig)
+{
+    const std::string binaryPath = textPath + "b";
+    const long long textTime = fileTime(textPath);
+    const long long binaryTime = fileTime(binaryPath);
+
+    // the cache is good as long as the text has not been edited since; mtimes
+    // are in seconds, so a cache from the same second is rebuilt to be safe
+    if (binaryTime >= 0 && binaryTime > textTime && readRigBinary(binaryPath, rig))
+        return true;
+    if (!parseRigText(textPath, rig))
+        return false;
+    // a failed cache write only costs a re-parse next time
+    writeRigBinary(binaryPath, rig);
+    return true;
+}
+
+static attachmentSlots layoutAttachments(const PartLayout& layout)
+{
+    attachmentSlots slots;
+    for (int dir = 0; dir < ATTACH_DIR_COUNT; ++dir)
+        slots[AttachmentDir(dir)] = AttachmentState(layout.attachments[dir]);
+    return slots;
+}
+
+// T(pos) * S(scale), built directly
+static glm::mat4 partLocalMatrix(const glm::vec3& pos, const glm::vec3& scale)
+{
+    glm::mat4 m(1.0f);
+    m.data[0] = scale.x;
+    m.data[5] = scale.y;
+    m.data[10] = scale.z;
+    m.data[12] = pos.x;
+    m.data[13] = pos.y;
+    m.data[14] = pos.z;
+    return m;
+}
+
+Rig::Rig(const RigDef& def) : _def(def), _typeJoints(rigTypeJoints(def))
+{
+    _partJoint.reserve(def.partCount);
+    _partLocal.reserve(def.partCount);
+    for (int i = 0; i < def.partCount; ++i)
+    {
+        const PartLayout& layout = def.parts[i];
+        bodyPart part(layout.center.x, layout.center.y, layout.center.z, BodyPartType(layout.type),
+                      layoutAttachments(layout));
+        part.setSize(layout.size);
+        _body.addPart(part);
+
+        glm::vec3 pos = layout.center;
+        if (layout.joint >= 0)
+            pos -= def.joints[layout.joint].pivot;
+        _partJoint.push_back(layout.joint);
+        _partLocal.push_back(partLocalMatrix(pos, layout.size));
+    }
+}
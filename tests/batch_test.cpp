@@ -0,0 +1,92 @@
+// mulBatch, mulPairs and transformPoints against the one-at-a-time operator*
+// and a scalar point transform, for every count up to a few blocks so the
+// partly filled last block is covered
+#include "glm.hpp"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static std::mt19937 rng(99);
+
+static glm::mat4 randomMatrix()
+{
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    glm::mat4 m;
+    for (float& x : m.data)
+        x = dist(rng);
+    return m;
+}
+
+// largest difference of element i, relative to the larger of 1 and the
+// sum of the magnitudes of the terms that produced it
+static float worstError(const float* got, const float* want, const float* size, int n)
+{
+    float worst = 0.0f;
+    for (int i = 0; i < n; ++i)
+        worst = std::fmax(worst, std::fabs(got[i] - want[i]) / std::fmax(size[i], 1.0f));
+    return worst;
+}
+
+static void termSizes(const glm::mat4& a, const glm::mat4& b, float* size)
+{
+    for (int col = 0; col < 4; ++col)
+        for (int row = 0; row < 4; ++row) {
+            size[col * 4 + row] = 0.0f;
+            for (int k = 0; k < 4; ++k)
+                size[col * 4 + row] += std::fabs(a.data[k * 4 + row] * b.data[col * 4 + k]);
+        }
+}
+
+int main()
+{
+    const int most = 4 * GLM_SIMD_WIDTH + 3;
+    float batch = 0.0f, pairs = 0.0f, points = 0.0f;
+    for (int n = 1; n <= most; ++n) {
+        std::vector<glm::mat4> a(n), b(n), out(n);
+        std::vector<glm::vec3> p(n), moved(n);
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        for (int i = 0; i < n; ++i) {
+            a[i] = randomMatrix();
+            b[i] = randomMatrix();
+            p[i] = glm::vec3(dist(rng), dist(rng), dist(rng));
+        }
+        float size[16];
+
+        glm::mulBatch(a.data(), b[0], out.data(), n);
+        for (int i = 0; i < n; ++i) {
+            termSizes(a[i], b[0], size);
+            batch = std::fmax(batch, worstError(out[i].data, (a[i] * b[0]).data, size, 16));
+        }
+
+        glm::mulPairs(a.data(), b.data(), out.data(), n);
+        for (int i = 0; i < n; ++i) {
+            termSizes(a[i], b[i], size);
+            pairs = std::fmax(pairs, worstError(out[i].data, (a[i] * b[i]).data, size, 16));
+        }
+
+        glm::transformPoints(a.data(), p.data(), moved.data(), n);
+        for (int i = 0; i < n; ++i) {
+            const float* m = a[i].data;
+            float want[3], got[3] = {moved[i].x, moved[i].y, moved[i].z};
+            for (int row = 0; row < 3; ++row) {
+                want[row] = m[row] * p[i].x + m[4 + row] * p[i].y + m[8 + row] * p[i].z + m[12 + row];
+                size[row] = std::fabs(m[row] * p[i].x) + std::fabs(m[4 + row] * p[i].y)
+                            + std::fabs(m[8 + row] * p[i].z) + std::fabs(m[12 + row]);
+            }
+            points = std::fmax(points, worstError(got, want, size, 3));
+        }
+    }
+
+    // same products in the same order: equal up to FMA contraction
+    bool ok = true;
+    const float bound = 1e-6f;
+    const char* names[] = {"mulBatch", "mulPairs", "transformPoints"};
+    const float errors[] = {batch, pairs, points};
+    for (int i = 0; i < 3; ++i) {
+        std::printf("batch_test: %s, counts 1..%d, max error %g: %s\n", names[i], most, errors[i],
+                    errors[i] <= bound ? "ok" : "FAIL");
+        ok = ok && errors[i] <= bound;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// a cross-fade cut off by another setState carries on from the pose it was
+// showing: the joint matrices must not jump at the switch
+#include "animation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static float worldDistance(const glm::mat4* a, const glm::mat4* b)
+{
+    float worst = 0.0f;
+    for (int j = 0; j < JOINT_COUNT; ++j)
+        for (int i = 0; i < 16; ++i)
+            worst = std::max(worst, std::fabs(a[j].data[i] - b[j].data[i]));
+    return worst;
+}
+
+int main()
+{
+    const Rig rig(RIG_DEFAULT);
+    BakedPoses baked;
+    baked.bake(60.0f);
+    const BakedPoses* sources[] = {nullptr, &baked};
+    bool ok = true;
+    for (const BakedPoses* source : sources) {
+        Animator animator;
+        animator.setState(WALKING, 0.0f);
+        animator.update(0.4f);
+        animator.setState(JUMPING, 0.5f);
+        animator.update(0.2f);
+        animator.evaluate(rig, source);
+        glm::mat4 before[JOINT_COUNT];
+        std::copy(animator.getJointWorld(), animator.getJointWorld() + JOINT_COUNT, before);
+
+        // cut off at 40% of the fade, then evaluated again without time passing
+        animator.setState(WAVING, 0.5f);
+        animator.evaluate(rig, source);
+        const float jump = worldDistance(before, animator.getJointWorld());
+        const bool cutOk = jump <= 1e-4f;
+        std::printf("fade_test: %s cut-off fade jumps %g: %s\n", source ? "baked" : "evaluated", jump,
+                    cutOk ? "ok" : "FAIL");
+
+        // and the new fade still ends on the new clip
+        Animator waving;
+        waving.setState(WAVING, 0.0f);
+        for (int i = 0; i < 6; ++i) {
+            animator.update(0.1f);
+            waving.update(0.1f);
+        }
+        animator.evaluate(rig, source);
+        waving.evaluate(rig, source);
+        const float left = worldDistance(animator.getJointWorld(), waving.getJointWorld());
+        const bool endOk = !animator.isFading() && left <= 1e-5f;
+        std::printf("fade_test: %s fade ends on the new clip, off by %g: %s\n", source ? "baked" : "evaluated",
+                    left, endOk ? "ok" : "FAIL");
+        ok = ok && cutOk && endOk;
+    }
+    return ok ? 0 : 1;
+}
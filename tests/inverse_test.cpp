@@ -0,0 +1,117 @@
+// inverseRigid, inverseAffine and inverse give inverse(M) * M = I on the
+// matrices each one accepts, and normalMatrix matches a double-precision
+// inverse-transpose under uniform and non-uniform scale
+#include "glm.hpp"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+static std::mt19937 rng(4321);
+
+static float uniform(float lo, float hi)
+{
+    return std::uniform_real_distribution<float>(lo, hi)(rng);
+}
+
+static glm::mat4 randomRigid()
+{
+    const glm::vec3 axis(uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f), uniform(0.1f, 1.0f));
+    const glm::mat4 T = glm::translate(glm::mat4(1.0f), glm::vec3(uniform(-50.0f, 50.0f), uniform(-50.0f, 50.0f),
+                                                                  uniform(-50.0f, 50.0f)));
+    return glm::rotate(T, uniform(-3.14f, 3.14f), glm::normalize(axis));
+}
+
+// largest |(A * M)_ij - I_ij|, relative to sum_k |A_ik * M_kj| when that is
+// over 1: the terms cancel down to 0 or 1, so their size is what rounding
+// errors scale with (the translation column); below 1 the error is absolute
+static float identityError(const glm::mat4& A, const glm::mat4& M)
+{
+    const glm::mat4 P = A * M;
+    float worst = 0.0f;
+    for (int col = 0; col < 4; ++col)
+        for (int row = 0; row < 4; ++row) {
+            float size = 0.0f;
+            for (int k = 0; k < 4; ++k)
+                size += std::fabs(A.data[k * 4 + row] * M.data[col * 4 + k]);
+            const float error = std::fabs(P.data[col * 4 + row] - (col == row ? 1.0f : 0.0f));
+            worst = std::fmax(worst, error / std::fmax(size, 1.0f));
+        }
+    return worst;
+}
+
+// transpose of the inverse of the upper 3x3 of M, by cofactors in double
+static void inverseTranspose(const glm::mat4& M, double* out)
+{
+    double a[3][3]; // a[col][row]
+    for (int col = 0; col < 3; ++col)
+        for (int row = 0; row < 3; ++row)
+            a[col][row] = M.data[col * 4 + row];
+    double det = 0.0;
+    for (int col = 0; col < 3; ++col)
+        for (int row = 0; row < 3; ++row) {
+            const int c1 = (col + 1) % 3, c2 = (col + 2) % 3, r1 = (row + 1) % 3, r2 = (row + 2) % 3;
+            // cofactor of (row, col); the inverse-transpose is cofactors / det
+            out[col * 3 + row] = a[c1][r1] * a[c2][r2] - a[c1][r2] * a[c2][r1];
+        }
+    for (int row = 0; row < 3; ++row)
+        det += a[0][row] * out[row];
+    for (int i = 0; i < 9; ++i)
+        out[i] /= det;
+}
+
+static float normalMatrixError(const glm::mat4& M)
+{
+    double ref[9];
+    inverseTranspose(M, ref);
+    const glm::mat3 N = glm::normalMatrix(M);
+    double worst = 0.0, size = 0.0;
+    for (int i = 0; i < 9; ++i) {
+        worst = std::fmax(worst, std::fabs(N.data[i] - ref[i]));
+        size = std::fmax(size, std::fabs(ref[i]));
+    }
+    return static_cast<float>(worst / size);
+}
+
+static bool report(const char* what, float error, float bound)
+{
+    const bool ok = error <= bound;
+    std::printf("inverse_test: %s, max error %g: %s\n", what, error, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main()
+{
+    const int count = 10000;
+    float rigid = 0.0f, rigidAffine = 0.0f, rigidFull = 0.0f, affine = 0.0f, affineFull = 0.0f;
+    float projection = 0.0f, uniformScale = 0.0f, nonUniformScale = 0.0f;
+    for (int n = 0; n < count; ++n) {
+        const glm::mat4 R = randomRigid();
+        rigid = std::fmax(rigid, identityError(glm::inverseRigid(R), R));
+        rigidAffine = std::fmax(rigidAffine, identityError(glm::inverseAffine(R), R));
+        rigidFull = std::fmax(rigidFull, identityError(glm::inverse(R), R));
+
+        // per-part scale on top of a rigid transform, plus a shear
+        glm::mat4 A = glm::scale(R, glm::vec3(uniform(0.2f, 5.0f), uniform(0.2f, 5.0f), uniform(0.2f, 5.0f)));
+        A.data[4] += uniform(-0.5f, 0.5f);
+        affine = std::fmax(affine, identityError(glm::inverseAffine(A), A));
+        affineFull = std::fmax(affineFull, identityError(glm::inverse(A), A));
+
+        const glm::mat4 P = glm::perspective(uniform(0.3f, 2.0f), uniform(0.5f, 2.5f), uniform(0.05f, 1.0f),
+                                             uniform(10.0f, 1000.0f));
+        projection = std::fmax(projection, identityError(glm::inverse(P), P));
+
+        const float s = uniform(0.2f, 5.0f);
+        uniformScale = std::fmax(uniformScale, normalMatrixError(glm::scale(R, glm::vec3(s, s, s))));
+        nonUniformScale = std::fmax(nonUniformScale, normalMatrixError(A));
+    }
+
+    bool ok = report("inverseRigid on rigid", rigid, 1e-5f);
+    ok = report("inverseAffine on rigid", rigidAffine, 1e-5f) && ok;
+    ok = report("inverse on rigid", rigidFull, 1e-5f) && ok;
+    ok = report("inverseAffine on scaled and sheared", affine, 1e-5f) && ok;
+    ok = report("inverse on scaled and sheared", affineFull, 1e-5f) && ok;
+    ok = report("inverse on perspective", projection, 1e-5f) && ok;
+    ok = report("normalMatrix under uniform scale", uniformScale, 1e-5f) && ok;
+    ok = report("normalMatrix under non-uniform scale", nonUniformScale, 1e-5f) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+// mul_simd against the mul_scalar reference on random matrices. Both add the
+// four column products in the same order, so they must agree bit for bit
+// unless the compiler is allowed to fuse the scalar loop into FMAs; then each
+// element may differ by a few ulps of the terms its dot product adds.
+#include "glm.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+int main()
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    const int count = 10000;
+    int exact = 0;
+    float worst = 0.0f;
+    for (int n = 0; n < count; ++n) {
+        glm::mat4 a, b;
+        for (int i = 0; i < 16; ++i) {
+            a.data[i] = dist(rng);
+            b.data[i] = dist(rng);
+        }
+        const glm::mat4 ref = glm::mul_scalar(a, b);
+        const glm::mat4 got = glm::mul_simd(a, b);
+        if (std::memcmp(ref.data, got.data, sizeof(ref.data)) == 0)
+            ++exact;
+        // error relative to sum_k |a_ik * b_kj|, the size of the terms the
+        // dot product adds: the result itself can cancel to near zero
+        for (int col = 0; col < 4; ++col)
+            for (int row = 0; row < 4; ++row) {
+                float scale = 0.0f;
+                for (int k = 0; k < 4; ++k)
+                    scale += std::fabs(a.data[k * 4 + row] * b.data[col * 4 + k]);
+                const int i = col * 4 + row;
+                const float err = scale > 0.0f ? std::fabs(ref.data[i] - got.data[i]) / scale : 0.0f;
+                worst = err > worst ? err : worst;
+            }
+    }
+#if defined(__FMA__)
+    // a fused multiply-add rounds once instead of twice: a few ulps of the terms
+    const bool ok = worst <= 1e-6f;
+#else
+    const bool ok = exact == count;
+#endif
+    std::printf("mat4_test: %d/%d bit-identical, max relative error %g: %s\n", exact, count, worst, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
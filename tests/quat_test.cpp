@@ -0,0 +1,77 @@
+// mat4_cast against rotating vectors with the quaternion itself and with
+// glm::rotate, and slerp against the properties nlerp lacks: unit length and
+// constant angular speed along the shortest arc
+#include "glm.hpp"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+static std::mt19937 rng(7);
+
+static float uniform(float lo, float hi)
+{
+    return std::uniform_real_distribution<float>(lo, hi)(rng);
+}
+
+static glm::vec3 randomVector()
+{
+    return glm::vec3(uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f));
+}
+
+// angle between two unit quaternions as 4D vectors, from the chord so it
+// stays accurate near 0
+static float arc(const glm::quat& a, const glm::quat& b)
+{
+    const float dw = a.w - b.w, dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return 2.0f * std::asin(std::fmin(1.0f, 0.5f * std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz)));
+}
+
+static bool report(const char* what, float error, float bound)
+{
+    const bool ok = error <= bound;
+    std::printf("quat_test: %s, max error %g: %s\n", what, error, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main()
+{
+    const int count = 10000;
+    float cast = 0.0f, castRotate = 0.0f, unit = 0.0f, speed = 0.0f, shortest = 0.0f, midpoint = 0.0f;
+    for (int n = 0; n < count; ++n) {
+        const glm::vec3 axis = randomVector() + glm::vec3(0.0f, 0.0f, 2.0f);
+        const float angle = uniform(-3.1f, 3.1f);
+        const glm::quat q = glm::angleAxis(angle, axis);
+        const glm::mat4 M = glm::mat4_cast(q);
+        const glm::mat4 R = glm::rotate(glm::mat4(1.0f), angle, axis);
+        const glm::vec3 v = randomVector();
+        const glm::vec3 byQuat = q * v;
+        for (int row = 0; row < 3; ++row) {
+            const float byMatrix = M.data[row] * v.x + M.data[4 + row] * v.y + M.data[8 + row] * v.z;
+            cast = std::fmax(cast, std::fabs(byMatrix - (&byQuat.x)[row]));
+            for (int col = 0; col < 4; ++col)
+                castRotate = std::fmax(castRotate, std::fabs(M.data[col * 4 + row] - R.data[col * 4 + row]));
+        }
+
+        const glm::quat a = glm::angleAxis(uniform(-3.1f, 3.1f), randomVector() + glm::vec3(0.0f, 2.0f, 0.0f));
+        glm::quat b = glm::angleAxis(uniform(-3.1f, 3.1f), randomVector() + glm::vec3(2.0f, 0.0f, 0.0f));
+        const glm::quat negB(-b.w, -b.x, -b.y, -b.z);
+        const float t = uniform(0.0f, 1.0f);
+        const glm::quat s = glm::slerp(a, b, t);
+        unit = std::fmax(unit, std::fabs(glm::dot(s, s) - 1.0f));
+        // -b is the same rotation: both take the shorter way round
+        shortest = std::fmax(shortest, arc(s, glm::slerp(a, negB, t)));
+        if (glm::dot(a, b) < 0.0f)
+            b = negB;
+        speed = std::fmax(speed, std::fabs(arc(a, s) - t * arc(a, b)));
+        // halfway both interpolations land on the same normalized midpoint
+        midpoint = std::fmax(midpoint, arc(glm::slerp(a, b, 0.5f), glm::nlerp(a, b, 0.5f)));
+    }
+
+    bool ok = report("mat4_cast rotates like the quaternion", cast, 1e-5f);
+    ok = report("mat4_cast matches glm::rotate", castRotate, 1e-5f) && ok;
+    ok = report("slerp stays unit length", unit, 1e-5f) && ok;
+    ok = report("slerp turns at constant speed", speed, 1e-4f) && ok;
+    ok = report("slerp takes the shortest arc", shortest, 1e-5f) && ok;
+    ok = report("slerp and nlerp meet halfway", midpoint, 1e-5f) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+// rig loading: the text rig matches RIG_DEFAULT, and a binary cache whose
+// header is fine but whose body indexes out of range is refused, with
+// loadRig falling back to the text
+#include "rig.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <utime.h>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    std::printf("rig_test: %s: %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok)
+        ++failures;
+}
+
+static bool sameRig(const RigDef& a, const RigDef& b)
+{
+    return std::memcmp(&a, &b, sizeof(RigDef)) == 0;
+}
+
+int main()
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string text = (dir / "humangl_rig_test.rig").string();
+    const std::string binary = text + "b";
+    std::filesystem::copy_file("rigs/human.rig", text, std::filesystem::copy_options::overwrite_existing);
+    std::remove(binary.c_str());
+
+    RigDef parsed{};
+    check(parseRigText(text, parsed) && sameRig(parsed, RIG_DEFAULT), "text rig parses to RIG_DEFAULT");
+
+    // each corruption keeps a valid header; the cache must still be refused
+    struct Corruption { const char* what; void (*apply)(RigDef&); };
+    const Corruption corruptions[] = {
+        {"part type out of range", [](RigDef& r) { r.parts[0].type = BODY_PART_TYPE_COUNT + 3; }},
+        {"part joint out of range", [](RigDef& r) { r.parts[2].joint = JOINT_COUNT; }},
+        {"part parent out of range", [](RigDef& r) { r.parts[3].parent = r.partCount; }},
+        {"joint parent out of range", [](RigDef& r) { r.joints[4].parent = -7; }},
+        {"joints out of order", [](RigDef& r) { r.joints[1].parent = 5; }},
+        {"attachment state out of range", [](RigDef& r) { r.parts[1].attachments[0] = 9; }},
+    };
+    for (const Corruption& c : corruptions) {
+        RigDef bad = RIG_DEFAULT;
+        c.apply(bad);
+        RigDef out = RIG_DEFAULT;
+        writeRigBinary(binary, bad);
+        check(!readRigBinary(binary, out), c.what);
+    }
+
+    // a cache newer than the text is normally used as is; a corrupt one is
+    // replaced by the parsed text
+    utimbuf old = {1000000000, 1000000000};
+    utime(text.c_str(), &old);
+    RigDef loaded{};
+    check(loadRig(text, loaded) && sameRig(loaded, RIG_DEFAULT), "loadRig falls back to the text");
+    RigDef cached{};
+    check(readRigBinary(binary, cached) && sameRig(cached, RIG_DEFAULT), "cache rebuilt from the text");
+
+    std::remove(text.c_str());
+    std::remove(binary.c_str());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+// glm::sincos and glm::sincosBatch against double-precision libm over the
+// documented range |x| <= 8192 (see the bounds above sincos in glm.hpp)
+#include "glm.hpp"
+#include <cstdio>
+#include <vector>
+
+#if defined(GLM_SINCOS_FAST)
+static const double BOUND = 2.7e-5;
+#else
+static const double BOUND = 1e-7;
+#endif
+
+int main()
+{
+    const int count = 1 << 21;
+    const double range = 8192.0;
+    std::vector<float> x(count), s(count), c(count);
+    for (int i = 0; i < count; ++i)
+        x[i] = static_cast<float>(-range + 2.0 * range * i / (count - 1));
+    glm::sincosBatch(x.data(), s.data(), c.data(), count);
+
+    double worstScalar = 0.0, worstBatch = 0.0;
+    float worstAt = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        float ss, cc;
+        glm::sincos(x[i], ss, cc);
+        const double rs = std::sin(static_cast<double>(x[i]));
+        const double rc = std::cos(static_cast<double>(x[i]));
+        const double es = std::fmax(std::fabs(ss - rs), std::fabs(cc - rc));
+        const double eb = std::fmax(std::fabs(s[i] - rs), std::fabs(c[i] - rc));
+        if (es > worstScalar) {
+            worstScalar = es;
+            worstAt = x[i];
+        }
+        worstBatch = std::fmax(worstBatch, eb);
+    }
+    const bool ok = worstScalar <= BOUND && worstBatch <= BOUND;
+    std::printf("sincos_test: max abs error %.3g scalar (at %g), %.3g batch, bound %.3g: %s\n",
+                worstScalar, worstAt, worstBatch, BOUND, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}